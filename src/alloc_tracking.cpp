@@ -0,0 +1,99 @@
+#include "alloc_tracking.h"
+
+#ifdef MQTT_ENABLE_ALLOC_TRACKING
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace mqtt_client {
+
+namespace {
+
+struct AtomicCounter {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+// 정적 초기화 전에도 operator new 가 호출될 수 있으므로 상수 초기화만 사용
+AtomicCounter g_counters[static_cast<size_t>(AllocSite::COUNT)];
+thread_local AllocSite t_site = AllocSite::OTHER;
+
+} // namespace
+
+AllocationStats allocation_stats() {
+    AllocationStats stats;
+    for (size_t i = 0; i < stats.size(); ++i) {
+        stats[i].allocations = g_counters[i].allocations.load(std::memory_order_relaxed);
+        stats[i].bytes = g_counters[i].bytes.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void reset_allocation_stats() {
+    for (auto& counter : g_counters) {
+        counter.allocations.store(0, std::memory_order_relaxed);
+        counter.bytes.store(0, std::memory_order_relaxed);
+    }
+}
+
+AllocSite exchange_alloc_site(AllocSite site) {
+    AllocSite previous = t_site;
+    t_site = site;
+    return previous;
+}
+
+} // namespace mqtt_client
+
+namespace {
+
+void* tracked_allocate(std::size_t size) {
+    auto& counter = mqtt_client::g_counters[static_cast<size_t>(mqtt_client::t_site)];
+    counter.allocations.fetch_add(1, std::memory_order_relaxed);
+    counter.bytes.fetch_add(size, std::memory_order_relaxed);
+    for (;;) {
+        if (void* ptr = std::malloc(size ? size : 1)) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (!handler) {
+            return nullptr;
+        }
+        handler();
+    }
+}
+
+} // namespace
+
+// 전역 operator new/delete 교체 (정렬 지정 버전은 표준 라이브러리 구현을 그대로 사용)
+void* operator new(std::size_t size) {
+    if (void* ptr = tracked_allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return tracked_allocate(size);
+    } catch (...) {
+        return nullptr;  // new_handler 가 bad_alloc 을 던진 경우
+    }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
+
+#endif // MQTT_ENABLE_ALLOC_TRACKING
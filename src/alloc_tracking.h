@@ -0,0 +1,70 @@
+#pragma once
+
+#include "client_export.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// 할당 추적 (CMake MQTT_ENABLE_ALLOC_TRACKING) - 전역 operator new 를 교체해 호출 지점별 할당 횟수/바이트를 센다
+//
+// 지점은 스레드별로 AllocScope 가 지정하며 (중첩 시 안쪽 지점), 지정되지 않은 할당은 OTHER 로 집계된다
+// 카운터는 프로세스 전체 누적이므로 여러 클라이언트의 할당이 합쳐진다
+// 비활성 빌드에서는 AllocScope 가 빈 객체이고 allocation_stats() 는 항상 0 을 반환한다
+// Windows 공유 라이브러리 빌드에서는 DLL 안의 할당만 집계된다 (정적 빌드 권장)
+enum class AllocSite : uint8_t {
+    OTHER,
+    ENQUEUE,    // request_subscribe / request_publish / request_unsubscribe (WorkItem 생성, 큐잉)
+    DISPATCH,   // MQTT 스레드의 작업 처리 (WorkItem 복사, 전송 중 테이블, Paho 전송)
+    CALLBACK,   // Paho 콜백 (수신 메시지 필터링, 캐시 갱신 등)
+    EVENT,      // MQTTEvent 생성과 이벤트 큐잉 (비행 기록 포함)
+    COUNT
+};
+
+struct AllocCounter {
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+};
+
+using AllocationStats = std::array<AllocCounter, static_cast<size_t>(AllocSite::COUNT)>;
+
+inline const char* alloc_site_to_string(AllocSite site) {
+    switch (site) {
+        case AllocSite::OTHER: return "OTHER";
+        case AllocSite::ENQUEUE: return "ENQUEUE";
+        case AllocSite::DISPATCH: return "DISPATCH";
+        case AllocSite::CALLBACK: return "CALLBACK";
+        case AllocSite::EVENT: return "EVENT";
+        default: return "UNKNOWN";
+    }
+}
+
+#ifdef MQTT_ENABLE_ALLOC_TRACKING
+MQTT_CLIENT_API AllocationStats allocation_stats();
+MQTT_CLIENT_API void reset_allocation_stats();
+// 현재 스레드의 지점을 바꾸고 이전 지점을 반환
+MQTT_CLIENT_API AllocSite exchange_alloc_site(AllocSite site);
+
+class AllocScope {
+public:
+    explicit AllocScope(AllocSite site) : previous_(exchange_alloc_site(site)) {}
+    ~AllocScope() { exchange_alloc_site(previous_); }
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    AllocSite previous_;
+};
+#else
+inline AllocationStats allocation_stats() { return {}; }
+inline void reset_allocation_stats() {}
+
+class AllocScope {
+public:
+    explicit AllocScope(AllocSite) {}
+};
+#endif
+
+} // namespace mqtt_client
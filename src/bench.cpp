@@ -0,0 +1,202 @@
+#include "mqtt_client.h"
+#include <iostream>
+#include <iomanip>
+#include <thread>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace mqtt_client;
+
+// 브로커 없이 수신 경로 / 이벤트 큐를 측정하는 마이크로 벤치마크
+// 같은 인자로 변경 전후 빌드를 실행해 ns/op 를 비교한다 (PGO 기본 학습 부하로도 사용)
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    size_t iterations = 1000000;
+    size_t topics = 64;
+    size_t payload_size = 64;
+};
+
+uint64_t total_allocations() {
+    uint64_t total = 0;
+    for (const auto& counter : allocation_stats()) {
+        total += counter.allocations;
+    }
+    return total;
+}
+
+// ops 회 실행한 fn 의 op 당 시간 (할당 추적 빌드에서는 op 당 할당 수도 출력)
+template <class Fn>
+void run_case(const std::string& name, size_t ops, Fn&& fn) {
+    uint64_t allocations = total_allocations();
+    auto start = Clock::now();
+    fn();
+    auto elapsed = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    double per_op = elapsed / static_cast<double>(ops);
+
+    std::cout << std::left << std::setw(36) << name << std::right << std::fixed
+              << std::setw(10) << std::setprecision(1) << per_op << " ns/op"
+              << std::setw(10) << std::setprecision(2) << 1000.0 / per_op << " Mops/s";
+#ifdef MQTT_ENABLE_ALLOC_TRACKING
+    std::cout << std::setw(10) << std::setprecision(2)
+              << static_cast<double>(total_allocations() - allocations) / static_cast<double>(ops)
+              << " allocs/op";
+#else
+    (void)allocations;
+#endif
+    std::cout << std::endl;
+}
+
+std::vector<std::string> make_topics(size_t count) {
+    std::vector<std::string> topics;
+    for (size_t i = 0; i < count; ++i) {
+        topics.push_back("bench/sensor/" + std::to_string(i) + "/value");
+    }
+    return topics;
+}
+
+void bench_event_queue(const Options& options, const std::vector<std::string>& topics,
+                       const std::string& payload) {
+    const size_t n = options.iterations;
+
+    // 한 스레드에서 push 후 pop (잠금 / 이동 비용)
+    {
+        EventQueue queue;
+        run_case("EventQueue push+pop (1 thread)", n, [&] {
+            for (size_t i = 0; i < n; ++i) {
+                queue.push(MQTTEvent(EventType::MESSAGE_ARRIVED, topics[i % topics.size()], payload, 1));
+                queue.try_pop();
+            }
+        });
+    }
+
+    // 생산자 / 소비자 스레드 (콜백 스레드 → 애플리케이션 스레드)
+    {
+        EventQueue queue;
+        run_case("EventQueue push/pop (2 threads)", n, [&] {
+            std::thread consumer([&] {
+                for (size_t received = 0; received < n;) {
+                    if (queue.pop(std::chrono::milliseconds(100)).has_value()) {
+                        ++received;
+                    }
+                }
+            });
+            for (size_t i = 0; i < n; ++i) {
+                queue.push(MQTTEvent(EventType::MESSAGE_ARRIVED, topics[i % topics.size()], payload, 1));
+            }
+            consumer.join();
+        });
+    }
+
+    // 최신 값 교체 (대기 중인 같은 토픽 이벤트를 덮어씀)
+    {
+        EventQueue queue;
+        run_case("EventQueue push_latest", n, [&] {
+            for (size_t i = 0; i < n; ++i) {
+                queue.push_latest(MQTTEvent(EventType::MESSAGE_ARRIVED, topics[i % topics.size()], payload, 1));
+            }
+            while (queue.try_pop().has_value()) {
+            }
+        });
+    }
+}
+
+void bench_receive_path(const Options& options, const std::vector<std::string>& topics,
+                        const std::string& payload) {
+    const size_t n = options.iterations;
+    // 이벤트 큐가 끝없이 커지지 않도록 주기적으로 비움 (소비 비용 포함)
+    const size_t drain_every = 1024;
+
+    MQTTConfig config;
+    config.broker_host = "localhost";
+    config.use_ssl = false;
+    config.use_websockets = false;
+
+    {
+        EventQueue queue;
+        MQTTClient client(config, queue);
+        run_case("on_message_arrived", n, [&] {
+            for (size_t i = 0; i < n; ++i) {
+                client.inject_message(topics[i % topics.size()], payload, 1);
+                if (i % drain_every == drain_every - 1) {
+                    while (queue.try_pop().has_value()) {
+                    }
+                }
+            }
+        });
+    }
+
+    // 와일드카드 샘플링 정책 (10개 중 1개 전달)
+    {
+        EventQueue queue;
+        MQTTClient client(config, queue);
+        client.request_subscribe("bench/sensor/+/value", 1, DeliveryPolicy::every_nth(10));
+        run_case("on_message_arrived (every_nth 10)", n, [&] {
+            for (size_t i = 0; i < n; ++i) {
+                client.inject_message(topics[i % topics.size()], payload, 1);
+                if (i % drain_every == drain_every - 1) {
+                    while (queue.try_pop().has_value()) {
+                    }
+                }
+            }
+        });
+    }
+}
+
+void print_usage() {
+    std::cout << R"(
+Usage:
+  mqtt_bench [options]
+
+Broker-less micro-benchmark of the receive path (on_message_arrived with an
+in-memory message) and EventQueue push/pop. Run the same options on builds
+before and after a change and compare ns/op.
+
+Options:
+  --iterations N  Operations per case (default 1000000)
+  --topics N      Distinct topics cycled through (default 64)
+  --payload N     Payload size in bytes (default 64)
+  -h, --help      Show this help
+)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    int arg_idx = 1;
+    while (arg_idx < argc) {
+        std::string arg = argv[arg_idx];
+        if (arg == "--iterations" && arg_idx + 1 < argc) {
+            options.iterations = std::max<size_t>(1, std::strtoull(argv[arg_idx + 1], nullptr, 10));
+            arg_idx += 2;
+        } else if (arg == "--topics" && arg_idx + 1 < argc) {
+            options.topics = std::max<size_t>(1, std::strtoull(argv[arg_idx + 1], nullptr, 10));
+            arg_idx += 2;
+        } else if (arg == "--payload" && arg_idx + 1 < argc) {
+            options.payload_size = std::strtoull(argv[arg_idx + 1], nullptr, 10);
+            arg_idx += 2;
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage();
+            return 0;
+        } else {
+            print_usage();
+            return 1;
+        }
+    }
+
+    std::vector<std::string> topics = make_topics(options.topics);
+    std::string payload(options.payload_size, 'x');
+
+    std::cout << "[Bench] " << options.iterations << " iterations, " << options.topics
+              << " topics, " << options.payload_size << " byte payload" << std::endl;
+    bench_event_queue(options, topics, payload);
+    bench_receive_path(options, topics, payload);
+    return 0;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// 공유 라이브러리 심볼 공개 (CMake MQTT_BUILD_SHARED)
+// 공유 빌드에서는 기본적으로 심볼을 숨기고 MQTT_CLIENT_API 로 표시한 공개 API 만 내보낸다
+// MQTT_CLIENT_SHARED 는 라이브러리와 사용자 모두, MQTT_CLIENT_BUILDING 은 라이브러리 빌드에만 정의된다
+#if defined(MQTT_CLIENT_SHARED)
+    #if defined(_WIN32)
+        #if defined(MQTT_CLIENT_BUILDING)
+            #define MQTT_CLIENT_API __declspec(dllexport)
+        #else
+            #define MQTT_CLIENT_API __declspec(dllimport)
+        #endif
+    #else
+        #define MQTT_CLIENT_API __attribute__((visibility("default")))
+    #endif
+#else
+    #define MQTT_CLIENT_API
+#endif
+
+// 명시적 인스턴스화 정의용 (GCC/Clang 은 extern template 선언의 표시를 따른다)
+#if defined(_WIN32)
+    #define MQTT_CLIENT_INSTANTIATION_API MQTT_CLIENT_API
+#else
+    #define MQTT_CLIENT_INSTANTIATION_API
+#endif
@@ -0,0 +1,119 @@
+#include "client_host.h"
+#include "log.h"
+#include <algorithm>
+
+namespace mqtt_client {
+
+ClientHost::ClientHost(size_t worker_count, std::chrono::milliseconds tick)
+    : tick_(tick) {
+    worker_count = std::max<size_t>(worker_count, 1);
+    for (size_t i = 0; i < worker_count; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+}
+
+ClientHost::~ClientHost() {
+    stop();
+}
+
+void ClientHost::add(std::shared_ptr<MQTTClient> client) {
+    auto it = std::min_element(workers_.begin(), workers_.end(), [](const auto& a, const auto& b) {
+        return a->count.load() < b->count.load();
+    });
+    Worker& worker = **it;
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (stopping_.load()) {
+        client->stop();  // 종료 중 추가된 클라이언트도 정상 종료 처리
+    }
+    worker.incoming.push_back(std::move(client));
+    worker.count.fetch_add(1);
+}
+
+void ClientHost::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    MQTT_LOG("[Host] Starting " << workers_.size() << " worker thread(s)");
+    for (auto& worker : workers_) {
+        Worker* w = worker.get();
+        w->thread = std::thread([this, w] { worker_loop(*w); });
+    }
+}
+
+void ClientHost::stop() {
+    if (!running_.load()) {
+        return;
+    }
+    MQTT_LOG("[Host] Stopping " << size() << " client(s)");
+    for (auto& worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        stopping_.store(true);
+        for (auto& client : worker->incoming) {
+            client->stop();
+        }
+    }
+    // 워커 스레드 전용 목록의 클라이언트는 워커가 stopping_ 을 보고 중지 요청
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+    running_.store(false);
+    stopping_.store(false);
+    MQTT_LOG("[Host] Stopped");
+}
+
+size_t ClientHost::size() const {
+    size_t total = 0;
+    for (const auto& worker : workers_) {
+        total += worker->count.load();
+    }
+    return total;
+}
+
+void ClientHost::worker_loop(Worker& worker) {
+    bool stop_requested = false;
+    while (true) {
+        auto tick_start = std::chrono::steady_clock::now();
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            for (auto& client : worker.incoming) {
+                worker.clients.push_back(std::move(client));
+            }
+            worker.incoming.clear();
+        }
+
+        if (stopping_.load() && !stop_requested) {
+            for (auto& client : worker.clients) {
+                client->stop();
+            }
+            stop_requested = true;
+        }
+
+        // 종료된 클라이언트는 목록에서 제거 (순서 유지 불필요)
+        for (size_t i = 0; i < worker.clients.size();) {
+            if (worker.clients[i]->poll_once()) {
+                ++i;
+                continue;
+            }
+            worker.clients[i] = std::move(worker.clients.back());
+            worker.clients.pop_back();
+            worker.count.fetch_sub(1);
+        }
+
+        if (stop_requested && worker.clients.empty()) {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            if (worker.incoming.empty()) {
+                return;
+            }
+            continue;
+        }
+
+        auto elapsed = std::chrono::steady_clock::now() - tick_start;
+        if (elapsed < tick_) {
+            std::this_thread::sleep_for(tick_ - elapsed);
+        }
+    }
+}
+
+} // namespace mqtt_client
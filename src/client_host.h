@@ -0,0 +1,56 @@
+#pragma once
+
+#include "mqtt_client.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+namespace mqtt_client {
+
+// 다수의 MQTTClient 를 고정 크기 워커 풀에서 구동 (클라이언트당 run() 스레드 없음)
+//
+// 각 클라이언트는 한 워커에 배정되어 tick 마다 poll_once() 로 구동된다
+// Paho 의 송수신 스레드는 프로세스 공용이므로 클라이언트 수와 무관하게 스레드 수가 고정되고,
+// 시스템 신뢰 저장소는 MQTTClient 가 프로세스 단위로 공유한다
+// 이벤트 큐는 클라이언트별로 둘 수도, 여러 클라이언트가 공유할 수도 있다
+class MQTT_CLIENT_API ClientHost {
+public:
+    explicit ClientHost(size_t worker_count = std::thread::hardware_concurrency(),
+                        std::chrono::milliseconds tick = std::chrono::milliseconds(100));
+    ~ClientHost();
+
+    ClientHost(const ClientHost&) = delete;
+    ClientHost& operator=(const ClientHost&) = delete;
+
+    // 클라이언트 추가 (Thread-safe, start() 전후 모두 가능) - 가장 적게 맡은 워커에 배정
+    // 클라이언트의 stop() 이 처리되면 (연결 종료 후) 호스트에서 제거된다
+    void add(std::shared_ptr<MQTTClient> client);
+
+    void start();
+    // 모든 클라이언트에 stop() 을 요청하고 연결 종료를 기다린 뒤 워커 종료
+    void stop();
+
+    size_t size() const;
+    size_t worker_count() const { return workers_.size(); }
+
+private:
+    struct Worker {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<MQTTClient>> incoming;  // add() 로 들어온 클라이언트
+        std::vector<std::shared_ptr<MQTTClient>> clients;   // 워커 스레드 전용
+        std::atomic<size_t> count{0};
+        std::thread thread;
+    };
+
+    void worker_loop(Worker& worker);
+
+    std::chrono::milliseconds tick_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace mqtt_client
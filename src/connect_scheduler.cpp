@@ -0,0 +1,10 @@
+#include "connect_scheduler.h"
+
+namespace mqtt_client {
+
+ConnectScheduler& ConnectScheduler::global() {
+    static ConnectScheduler scheduler;
+    return scheduler;
+}
+
+} // namespace mqtt_client
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "client_export.h"
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace mqtt_client {
+
+// 프로세스 공용 연결 스케줄러 (연결 폭주 제어)
+//
+// 많은 클라이언트가 동시에 시작할 때 TLS 설정/핸드셰이크가 CPU 를 포화시키고
+// 브로커의 연결 속도 제한에 걸리지 않도록, 연결 시도를 동시 진행 수와 초당 시작 수로 제한한다
+// 클라이언트는 poll_once() 에서 차례를 기다리며 (블로킹 없음), 허가는 연결 성공/실패 시 반납된다
+// 기본값은 제한 없음
+class MQTT_CLIENT_API ConnectScheduler {
+public:
+    struct Stats {
+        uint64_t granted = 0;
+        uint64_t succeeded = 0;
+        uint64_t failed = 0;
+        size_t waiting = 0;
+        size_t in_flight = 0;
+        std::chrono::milliseconds max_wait{0};
+        std::chrono::milliseconds total_wait{0};
+        // 대기가 시작된 시점부터 마지막 연결 완료까지 (waiting/in_flight 가 0 이면 확정값)
+        std::chrono::milliseconds time_to_all_connected{0};
+    };
+
+    // 프로세스당 하나 - 공유 라이브러리 빌드에서도 사용자와 라이브러리가 같은 인스턴스를 쓰도록 라이브러리 안에 정의
+    static ConnectScheduler& global();
+
+    // max_concurrent: 동시에 진행 중인 연결 시도 수 (0 = 제한 없음)
+    // connects_per_second: 초당 연결 시작 수 (0 = 제한 없음)
+    // burst: 놓친 시작 슬롯을 몰아서 쓸 수 있는 최대 개수 (0 = 폴링 주기 100ms 분량)
+    void configure(size_t max_concurrent, double connects_per_second, size_t burst = 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        max_concurrent_ = max_concurrent;
+        interval_ = connects_per_second > 0
+            ? std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                  std::chrono::duration<double>(1.0 / connects_per_second))
+            : std::chrono::steady_clock::duration::zero();
+        if (burst == 0) {
+            burst = std::max<size_t>(1, static_cast<size_t>(connects_per_second / 10));
+        }
+        tolerance_ = interval_ * static_cast<int64_t>(burst - 1);
+    }
+
+    // 대기 시작 (클라이언트당 연결 시도마다 한 번)
+    void enqueue() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (waiting_ == 0 && in_flight_ == 0) {
+            burst_started_ = std::chrono::steady_clock::now();
+            last_completed_ = burst_started_;
+        }
+        ++waiting_;
+    }
+
+    // 차례가 되었으면 허가 (블로킹 없음)
+    bool try_acquire(std::chrono::steady_clock::time_point queued_at) {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (max_concurrent_ > 0 && in_flight_ >= max_concurrent_) {
+            return false;
+        }
+        // GCRA: 이론상 다음 시작 시각이 burst 허용 범위 안이면 시작
+        if (next_start_ - tolerance_ > now) {
+            return false;
+        }
+        next_start_ = std::max(next_start_, now) + interval_;
+        --waiting_;
+        ++in_flight_;
+        ++granted_;
+        auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(now - queued_at);
+        max_wait_ = std::max(max_wait_, wait);
+        total_wait_ += wait;
+        return true;
+    }
+
+    // 대기 중 중지
+    void cancel() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --waiting_;
+    }
+
+    // 연결 시도 완료 (성공/실패)
+    void release(bool success) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --in_flight_;
+        ++(success ? succeeded_ : failed_);
+        last_completed_ = std::chrono::steady_clock::now();
+    }
+
+    Stats get_stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Stats stats;
+        stats.granted = granted_;
+        stats.succeeded = succeeded_;
+        stats.failed = failed_;
+        stats.waiting = waiting_;
+        stats.in_flight = in_flight_;
+        stats.max_wait = max_wait_;
+        stats.total_wait = total_wait_;
+        auto end = (waiting_ == 0 && in_flight_ == 0) ? last_completed_ : std::chrono::steady_clock::now();
+        stats.time_to_all_connected =
+            std::chrono::duration_cast<std::chrono::milliseconds>(end - burst_started_);
+        return stats;
+    }
+
+private:
+    ConnectScheduler() = default;
+
+    mutable std::mutex mutex_;
+    size_t max_concurrent_ = 0;
+    std::chrono::steady_clock::duration interval_{0};
+    std::chrono::steady_clock::duration tolerance_{0};
+    std::chrono::steady_clock::time_point next_start_;
+
+    size_t waiting_ = 0;
+    size_t in_flight_ = 0;
+    uint64_t granted_ = 0;
+    uint64_t succeeded_ = 0;
+    uint64_t failed_ = 0;
+    std::chrono::milliseconds max_wait_{0};
+    std::chrono::milliseconds total_wait_{0};
+    std::chrono::steady_clock::time_point burst_started_;
+    std::chrono::steady_clock::time_point last_completed_;
+};
+
+} // namespace mqtt_client
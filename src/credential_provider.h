@@ -0,0 +1,138 @@
+#pragma once
+
+#include "log.h"
+#include <string>
+#include <chrono>
+#include <optional>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <algorithm>
+
+namespace mqtt_client {
+
+struct Credentials {
+    std::string username;
+    std::string password;   // JWT / OAuth access token 등
+    // 만료 시각 (max() 이면 만료 없음)
+    std::chrono::system_clock::time_point expires_at = std::chrono::system_clock::time_point::max();
+};
+
+// 연결/재연결 시 사용할 자격 증명 공급자
+// current() 는 연결 경로에서 호출되므로 절대 블로킹(토큰 발급)하지 않아야 한다
+class CredentialProvider {
+public:
+    virtual ~CredentialProvider() = default;
+
+    // 캐시된 자격 증명. 아직 준비되지 않았으면 nullopt
+    virtual std::optional<Credentials> current() const = 0;
+};
+
+// 고정 자격 증명
+class StaticCredentialProvider : public CredentialProvider {
+public:
+    explicit StaticCredentialProvider(Credentials credentials)
+        : credentials_(std::move(credentials)) {}
+
+    std::optional<Credentials> current() const override { return credentials_; }
+
+private:
+    Credentials credentials_;
+};
+
+// 토큰 발급 함수를 백그라운드 스레드에서 만료 전에 미리 호출해 캐시하는 공급자
+// fetcher 는 블로킹해도 되며 (JWT 서명, OAuth 토큰 요청 등), 실패 시 예외를 던지면
+// retry_interval 후 다시 시도한다. 기존 토큰은 새 토큰을 받을 때까지 유지된다.
+class RefreshingCredentialProvider : public CredentialProvider {
+public:
+    using Fetcher = std::function<Credentials()>;
+
+    explicit RefreshingCredentialProvider(Fetcher fetcher,
+                                          std::chrono::seconds refresh_margin = std::chrono::seconds(60),
+                                          std::chrono::seconds retry_interval = std::chrono::seconds(5))
+        : fetcher_(std::move(fetcher)),
+          refresh_margin_(refresh_margin),
+          retry_interval_(retry_interval) {
+        thread_ = std::thread([this] { refresh_loop(); });
+    }
+
+    ~RefreshingCredentialProvider() override {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+
+    RefreshingCredentialProvider(const RefreshingCredentialProvider&) = delete;
+    RefreshingCredentialProvider& operator=(const RefreshingCredentialProvider&) = delete;
+
+    std::optional<Credentials> current() const override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return cached_;
+    }
+
+    // 다음 갱신을 즉시 수행 (예: 브로커가 인증 실패로 연결을 거부한 경우)
+    void refresh_now() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            refresh_requested_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    void refresh_loop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (!stop_) {
+            refresh_requested_ = false;
+            lock.unlock();
+
+            std::optional<Credentials> fresh;
+            try {
+                fresh = fetcher_();
+            } catch (const std::exception& e) {
+                MQTT_LOG_ERROR("[Auth] Credential refresh failed: " << e.what());
+            } catch (...) {
+                // 예외 타입과 무관하게 재시도 (백그라운드 스레드에서 terminate 되지 않도록)
+                MQTT_LOG_ERROR("[Auth] Credential refresh failed: unknown exception");
+            }
+
+            lock.lock();
+            auto next = std::chrono::system_clock::now() + retry_interval_;
+            if (fresh.has_value()) {
+                cached_ = std::move(fresh);
+                if (cached_->expires_at != std::chrono::system_clock::time_point::max()) {
+                    // 만료 refresh_margin 전에 갱신 (최소 retry_interval 간격)
+                    next = std::max(cached_->expires_at - refresh_margin_, next);
+                } else {
+                    next = std::chrono::system_clock::time_point::max();
+                }
+                MQTT_LOG("[Auth] Credentials refreshed");
+            }
+
+            if (next == std::chrono::system_clock::time_point::max()) {
+                cv_.wait(lock, [this] { return stop_ || refresh_requested_; });
+            } else {
+                cv_.wait_until(lock, next, [this] { return stop_ || refresh_requested_; });
+            }
+        }
+    }
+
+    Fetcher fetcher_;
+    std::chrono::seconds refresh_margin_;
+    std::chrono::seconds retry_interval_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::optional<Credentials> cached_;
+    bool stop_ = false;
+    bool refresh_requested_ = false;
+    std::thread thread_;
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,240 @@
+#pragma once
+
+#include "topic_filter.h"
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <functional>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// QoS 1 재전송 중복 제거 필터 (수신 경로용, 생성 이후 할당 없음)
+//
+// 1) 시간 창 Bloom 필터 (2세대 교대) - 처음 보는 키를 빠르게 통과
+// 2) 정확한 LRU (고정 용량, 개방 주소 해시) - Bloom 양성일 때 확인
+//
+// 기본 키는 (토픽, 패킷 ID) 이며, 브로커 재전송(DUP 플래그)만 중복으로 판단한다
+// 패킷 ID 는 세션 내에서 재사용되므로, 발행자가 메시지 ID 를 페이로드에 넣는 경우
+// KeyExtractor 로 그 값을 키로 쓰는 것이 정확하다 (이 경우 DUP 플래그와 무관하게 판단)
+class DedupFilter {
+public:
+    // nullopt 를 반환하면 중복 검사 대상이 아님
+    using KeyExtractor = std::function<std::optional<uint64_t>(std::string_view topic,
+                                                                std::string_view payload)>;
+
+    explicit DedupFilter(size_t capacity = 8192,
+                         std::chrono::milliseconds window = std::chrono::seconds(30),
+                         KeyExtractor key_extractor = nullptr)
+        : window_(window),
+          key_extractor_(std::move(key_extractor)),
+          bloom_bits_(next_pow2(capacity * 16)),
+          bloom_{std::vector<uint64_t>(bloom_bits_ / 64), std::vector<uint64_t>(bloom_bits_ / 64)},
+          nodes_(capacity > 0 ? capacity : 1),
+          table_(next_pow2(nodes_.size() * 2), kEmpty) {
+        last_rotation_ = std::chrono::steady_clock::now();
+    }
+
+    DedupFilter(const DedupFilter&) = delete;
+    DedupFilter& operator=(const DedupFilter&) = delete;
+
+    // 중복이면 true (처음 보는 메시지는 기록 후 false)
+    bool is_duplicate(std::string_view topic, std::string_view payload, int msgid, bool dup_flag) {
+        std::optional<uint64_t> key;
+        bool require_dup_flag = false;
+        if (key_extractor_) {
+            key = key_extractor_(topic, payload);
+        } else if (msgid != 0) {  // QoS 0 에는 패킷 ID 가 없음
+            key = topic_hash(topic) ^ mix(static_cast<uint64_t>(msgid));
+            require_dup_flag = true;
+        }
+        if (!key.has_value()) {
+            return false;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        rotate_bloom(now);
+
+        bool maybe_seen = bloom_contains(key.value());
+        bloom_insert(key.value());
+
+        // Bloom 세대에서 빠진 키도 LRU 에는 남아 있을 수 있으므로 항상 조회한다
+        // (같은 키의 노드가 둘이 되면 퇴출 시 다른 슬롯을 지워 해시 테이블이 가득 찬다)
+        uint32_t index = lru_find(key.value());
+        bool seen = maybe_seen && index != kEmpty && now - nodes_[index].seen <= window_;
+        if (index != kEmpty) {
+            nodes_[index].seen = now;
+            lru_touch(index);
+        } else {
+            lru_insert(key.value(), now);
+        }
+        if (seen && (!require_dup_flag || dup_flag)) {
+            duplicates_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    uint64_t duplicates() const { return duplicates_.load(std::memory_order_relaxed); }
+
+    // 해시 테이블의 사용 중인 슬롯 수 (진단용 - 항상 추적 중인 키 수와 같아야 한다)
+    size_t occupied_slots() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t count = 0;
+        for (uint32_t index : table_) {
+            count += index != kEmpty ? 1 : 0;
+        }
+        return count;
+    }
+
+private:
+    static constexpr uint32_t kEmpty = 0xffffffffu;
+
+    struct Node {
+        uint64_t key = 0;
+        std::chrono::steady_clock::time_point seen;
+        uint32_t prev = kEmpty;
+        uint32_t next = kEmpty;
+    };
+
+    static size_t next_pow2(size_t n) {
+        size_t p = 64;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    static uint64_t mix(uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    // ---- Bloom (k = 3, 이중 해싱) ----
+    void rotate_bloom(std::chrono::steady_clock::time_point now) {
+        // 창의 절반마다 세대 교대 → 각 키는 최소 window/2, 최대 window 동안 유지
+        if (now - last_rotation_ < window_ / 2) {
+            return;
+        }
+        current_ ^= 1;
+        std::fill(bloom_[current_].begin(), bloom_[current_].end(), 0);
+        last_rotation_ = now;
+    }
+
+    bool bloom_contains(uint64_t key) const {
+        uint64_t h1 = mix(key);
+        uint64_t h2 = mix(h1) | 1;
+        for (int gen = 0; gen < 2; ++gen) {
+            bool all = true;
+            for (uint64_t i = 0; i < 3 && all; ++i) {
+                size_t bit = (h1 + i * h2) & (bloom_bits_ - 1);
+                all = (bloom_[gen][bit / 64] >> (bit % 64)) & 1;
+            }
+            if (all) return true;
+        }
+        return false;
+    }
+
+    void bloom_insert(uint64_t key) {
+        uint64_t h1 = mix(key);
+        uint64_t h2 = mix(h1) | 1;
+        for (uint64_t i = 0; i < 3; ++i) {
+            size_t bit = (h1 + i * h2) & (bloom_bits_ - 1);
+            bloom_[current_][bit / 64] |= uint64_t{1} << (bit % 64);
+        }
+    }
+
+    // ---- LRU (이중 연결 리스트 + 선형 탐사 해시) ----
+    uint32_t lru_find(uint64_t key) const {
+        size_t mask = table_.size() - 1;
+        for (size_t pos = mix(key) & mask;; pos = (pos + 1) & mask) {
+            uint32_t index = table_[pos];
+            if (index == kEmpty) return kEmpty;
+            if (nodes_[index].key == key) return index;
+        }
+    }
+
+    // key 가 LRU 에 없을 때만 호출
+    void lru_insert(uint64_t key, std::chrono::steady_clock::time_point now) {
+        uint32_t index;
+        if (size_ < nodes_.size()) {
+            index = static_cast<uint32_t>(size_++);
+        } else {
+            index = tail_;  // 가장 오래된 항목 재사용
+            table_erase(nodes_[index].key);
+            lru_unlink(index);
+        }
+        nodes_[index].key = key;
+        nodes_[index].seen = now;
+        lru_push_front(index);
+
+        size_t mask = table_.size() - 1;
+        size_t pos = mix(key) & mask;
+        while (table_[pos] != kEmpty) pos = (pos + 1) & mask;
+        table_[pos] = index;
+    }
+
+    // backward-shift 삭제 (툼스톤 없음)
+    void table_erase(uint64_t key) {
+        size_t mask = table_.size() - 1;
+        size_t pos = mix(key) & mask;
+        while (table_[pos] != kEmpty && nodes_[table_[pos]].key != key) pos = (pos + 1) & mask;
+        if (table_[pos] == kEmpty) return;
+        size_t hole = pos;
+        for (size_t next = (hole + 1) & mask; table_[next] != kEmpty; next = (next + 1) & mask) {
+            size_t home = mix(nodes_[table_[next]].key) & mask;
+            // home 이 (hole, next] 범위 밖이면 hole 로 이동 가능
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                table_[hole] = table_[next];
+                hole = next;
+            }
+        }
+        table_[hole] = kEmpty;
+    }
+
+    void lru_touch(uint32_t index) {
+        if (head_ == index) return;
+        lru_unlink(index);
+        lru_push_front(index);
+    }
+
+    void lru_unlink(uint32_t index) {
+        Node& node = nodes_[index];
+        if (node.prev != kEmpty) nodes_[node.prev].next = node.next; else head_ = node.next;
+        if (node.next != kEmpty) nodes_[node.next].prev = node.prev; else tail_ = node.prev;
+        node.prev = node.next = kEmpty;
+    }
+
+    void lru_push_front(uint32_t index) {
+        nodes_[index].prev = kEmpty;
+        nodes_[index].next = head_;
+        if (head_ != kEmpty) nodes_[head_].prev = index;
+        head_ = index;
+        if (tail_ == kEmpty) tail_ = index;
+    }
+
+    std::chrono::milliseconds window_;
+    KeyExtractor key_extractor_;
+
+    mutable std::mutex mutex_;  // 전환 중에는 두 연결의 수신 스레드가 공유
+    size_t bloom_bits_;
+    std::vector<uint64_t> bloom_[2];
+    int current_ = 0;
+    std::chrono::steady_clock::time_point last_rotation_;
+
+    std::vector<Node> nodes_;
+    std::vector<uint32_t> table_;
+    size_t size_ = 0;
+    uint32_t head_ = kEmpty;
+    uint32_t tail_ = kEmpty;
+
+    std::atomic<uint64_t> duplicates_{0};
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "topic_filter.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <cstring>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// 원시 페이로드 조건 (수신 스레드에서 복사 전에 호출되므로 가볍고 블로킹 없어야 함)
+using PayloadPredicate = std::function<bool(std::string_view payload)>;
+
+namespace detail {
+
+// memchr(벡터화됨)로 첫 바이트 후보를 건너뛰며 검색
+inline const char* find_bytes(const char* begin, const char* end, std::string_view needle) {
+    if (needle.empty()) {
+        return begin;
+    }
+    while (end - begin >= static_cast<std::ptrdiff_t>(needle.size())) {
+        auto* hit = static_cast<const char*>(
+            std::memchr(begin, needle[0], static_cast<size_t>(end - begin) - needle.size() + 1));
+        if (!hit) {
+            return nullptr;
+        }
+        if (std::memcmp(hit, needle.data(), needle.size()) == 0) {
+            return hit;
+        }
+        begin = hit + 1;
+    }
+    return nullptr;
+}
+
+inline const char* skip_json_space(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r')) {
+        ++p;
+    }
+    return p;
+}
+
+} // namespace detail
+
+inline PayloadPredicate payload_equals(std::string value) {
+    return [value = std::move(value)](std::string_view payload) { return payload == value; };
+}
+
+inline PayloadPredicate payload_prefix(std::string prefix) {
+    return [prefix = std::move(prefix)](std::string_view payload) {
+        return payload.size() >= prefix.size() &&
+               std::memcmp(payload.data(), prefix.data(), prefix.size()) == 0;
+    };
+}
+
+// JSON 필드 값 비교 (파싱 없이 "field" 키를 스캔)
+// value 는 문자열 값("value") 또는 숫자/true/false/null 리터럴과 일치한다
+// 중첩 객체의 같은 이름 필드도 일치하며, 이스케이프된 문자열은 원문 그대로 비교한다
+inline PayloadPredicate json_field_equals(std::string field, std::string value) {
+    return [key = "\"" + field + "\"", value = std::move(value)](std::string_view payload) {
+        const char* p = payload.data();
+        const char* end = p + payload.size();
+        while ((p = detail::find_bytes(p, end, key)) != nullptr) {
+            p += key.size();
+            const char* q = detail::skip_json_space(p, end);
+            if (q == end || *q != ':') {
+                continue;  // 키가 아니라 값으로 등장
+            }
+            q = detail::skip_json_space(q + 1, end);
+            if (q == end) {
+                break;
+            }
+            size_t remaining = static_cast<size_t>(end - q);
+            if (*q == '"') {
+                if (remaining >= value.size() + 2 &&
+                    std::memcmp(q + 1, value.data(), value.size()) == 0 && q[1 + value.size()] == '"') {
+                    return true;
+                }
+            } else if (remaining >= value.size() && std::memcmp(q, value.data(), value.size()) == 0) {
+                const char* after = q + value.size();
+                if (after == end || *after == ',' || *after == '}' || *after == ']' ||
+                    *after == ' ' || *after == '\n' || *after == '\r' || *after == '\t') {
+                    return true;
+                }
+            }
+        }
+        return false;
+    };
+}
+
+// 구독별 전달 정책 (고빈도 토픽 샘플링 / 내용 조건)
+struct DeliveryPolicy {
+    enum class Mode {
+        ALL,            // 모두 전달
+        EVERY_NTH,      // N 번째 메시지마다 전달
+        MIN_INTERVAL,   // 간격당 최대 1개 (간격 내 나머지는 버림)
+        LATEST_ONLY     // 큐에 대기 중인 이전 값을 최신 값으로 교체 (소비 시점의 최신 값만)
+    };
+
+    Mode mode = Mode::ALL;
+    uint32_t every_n = 1;
+    std::chrono::milliseconds min_interval{0};
+    PayloadPredicate predicate;     // 설정 시 조건을 만족하는 메시지만 샘플링 대상
+
+    // 페이로드 조건 추가 (예: DeliveryPolicy::all().where(payload_equals("shutdown")))
+    DeliveryPolicy where(PayloadPredicate condition) const {
+        DeliveryPolicy policy = *this;
+        policy.predicate = std::move(condition);
+        return policy;
+    }
+
+    static DeliveryPolicy all() { return DeliveryPolicy{}; }
+    static DeliveryPolicy every_nth(uint32_t n) {
+        DeliveryPolicy policy;
+        policy.mode = Mode::EVERY_NTH;
+        policy.every_n = n > 0 ? n : 1;
+        return policy;
+    }
+    static DeliveryPolicy at_most_every(std::chrono::milliseconds interval) {
+        DeliveryPolicy policy;
+        policy.mode = Mode::MIN_INTERVAL;
+        policy.min_interval = interval;
+        return policy;
+    }
+    static DeliveryPolicy latest_only() {
+        DeliveryPolicy policy;
+        policy.mode = Mode::LATEST_ONLY;
+        return policy;
+    }
+};
+
+// 구독 필터별 정책 테이블 - 수신 경로에서 이벤트 생성 전에 원시 페이로드로 평가
+// 상태(카운터/마지막 전달 시각)는 실제 토픽별로 유지한다 (와일드카드 구독의 각 토픽을 따로 샘플링)
+//
+// 토픽 상태는 kStateSlots 칸의 고정 해시 테이블 (직접 사상, 첫 정책 등록 시 한 번 할당)
+// 토픽 수와 관계없이 메모리가 고정되며 수신 경로에서 할당하지 않는다
+// 같은 칸을 쓰는 토픽이 번갈아 오면 상태가 초기화되어 더 많이 전달될 수 있다 (덜 전달하지는 않음)
+class DeliveryPolicies {
+public:
+    enum class Action { DELIVER, DROP, CONFLATE };
+
+    static constexpr size_t kStateSlots = 4096;  // 2의 거듭제곱
+
+    void set(const std::string& filter, const DeliveryPolicy& policy) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        bool found = false;
+        for (auto& rule : rules_) {
+            if (rule.filter == filter) {
+                rule.policy = policy;
+                found = true;
+            }
+        }
+        if (!found) {
+            rules_.push_back(Rule{filter, policy});
+        }
+        reset_states();
+        active_.store(!rules_.empty(), std::memory_order_release);
+    }
+
+    void remove(const std::string& filter) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = rules_.begin(); it != rules_.end(); ++it) {
+            if (it->filter == filter) {
+                rules_.erase(it);
+                reset_states();
+                break;
+            }
+        }
+        active_.store(!rules_.empty(), std::memory_order_release);
+    }
+
+    // 처음 일치하는 구독 필터의 정책 적용 (정책이 없으면 잠금 없이 DELIVER)
+    Action evaluate(std::string_view topic, std::string_view payload) {
+        if (!active_.load(std::memory_order_acquire)) {
+            return Action::DELIVER;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        const Rule* rule = nullptr;
+        for (const auto& candidate : rules_) {
+            if (topic_matches(candidate.filter, topic)) {
+                rule = &candidate;
+                break;
+            }
+        }
+        if (!rule) {
+            return Action::DELIVER;
+        }
+        if (rule->policy.predicate && !rule->policy.predicate(payload)) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return Action::DROP;
+        }
+
+        switch (rule->policy.mode) {
+            case DeliveryPolicy::Mode::ALL:
+                return Action::DELIVER;
+            case DeliveryPolicy::Mode::EVERY_NTH: {
+                State& state = state_for(topic);
+                if (state.count++ % rule->policy.every_n == 0) {
+                    return Action::DELIVER;
+                }
+                break;
+            }
+            case DeliveryPolicy::Mode::MIN_INTERVAL: {
+                State& state = state_for(topic);
+                auto now = std::chrono::steady_clock::now();
+                if (state.count++ == 0 || now - state.last_delivered >= rule->policy.min_interval) {
+                    state.last_delivered = now;
+                    return Action::DELIVER;
+                }
+                break;
+            }
+            case DeliveryPolicy::Mode::LATEST_ONLY:
+                return Action::CONFLATE;
+        }
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return Action::DROP;
+    }
+
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Rule {
+        std::string filter;
+        DeliveryPolicy policy;
+    };
+
+    struct State {
+        uint64_t topic = 0;  // 토픽 해시 (칸 소유자)
+        uint64_t count = 0;
+        std::chrono::steady_clock::time_point last_delivered;
+    };
+
+    // mutex_ 보유 상태에서 호출
+    State& state_for(std::string_view topic) {
+        uint64_t hash = topic_hash(topic);
+        State& state = states_[hash & (kStateSlots - 1)];
+        if (state.topic != hash) {
+            state = State{hash, 0, {}};  // 다른 토픽이 쓰던 칸 - 새 토픽으로 교체
+        }
+        return state;
+    }
+
+    void reset_states() {
+        if (rules_.empty()) {
+            states_.clear();
+            states_.shrink_to_fit();
+        } else {
+            states_.assign(kStateSlots, State{});
+        }
+    }
+
+    std::atomic<bool> active_{false};
+    std::mutex mutex_;  // 전환 중에는 두 연결의 수신 스레드가 공유
+    std::vector<Rule> rules_;
+    std::vector<State> states_;  // 토픽 해시 칸 → 상태 (정책이 있을 때만 kStateSlots 칸)
+    std::atomic<uint64_t> dropped_{0};
+};
+
+} // namespace mqtt_client
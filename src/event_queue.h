@@ -1,6 +1,8 @@
 #pragma once
 
+#include "tracing.h"
 #include <queue>
+#include <unordered_map>
 #include <mutex>
 #include <condition_variable>
 #include <optional>
@@ -18,6 +20,7 @@ enum class EventType {
     SUBSCRIBE_FAILURE,
     PUBLISH_SUCCESS,
     PUBLISH_FAILURE,
+    SEQUENCE_GAP,
     ERROR
 };
 
@@ -28,6 +31,11 @@ struct MQTTEvent {
     std::string message;
     int qos{0};
     int token{0};
+    bool retained{false};       // 브로커의 retained 메시지
+    bool from_snapshot{false};  // 로컬 retained 캐시에서 재생된 값 (연결 전)
+#ifdef MQTT_ENABLE_TRACING
+    TraceContext trace;         // 수신 추적 문맥 (샘플링된 메시지만)
+#endif
 
     MQTTEvent() = default;
     MQTTEvent(EventType t, const std::string& msg = "") : type(t), message(msg) {}
@@ -44,16 +52,31 @@ public:
 
     void push(MQTTEvent event) {
         std::lock_guard<std::mutex> lock(mutex_);
-        queue_.push(std::move(event));
+        queue_.push(Entry{std::move(event), false});
+        cv_.notify_one();
+    }
+
+    // 같은 토픽의 대기 중인 이벤트를 최신 값으로 교체 (없으면 새로 큐잉)
+    // 교체된 이벤트는 처음 큐잉된 위치에서 최신 내용으로 전달된다
+    void push_latest(MQTTEvent event) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = latest_.find(event.topic);
+        if (it != latest_.end()) {
+            it->second = std::move(event);
+            ++conflated_;
+            return;
+        }
+        MQTTEvent marker;
+        marker.topic = event.topic;
+        latest_.emplace(event.topic, std::move(event));
+        queue_.push(Entry{std::move(marker), true});
         cv_.notify_one();
     }
 
     std::optional<MQTTEvent> pop(std::chrono::milliseconds timeout = std::chrono::milliseconds(100)) {
         std::unique_lock<std::mutex> lock(mutex_);
         if (cv_.wait_for(lock, timeout, [this] { return !queue_.empty(); })) {
-            auto event = std::move(queue_.front());
-            queue_.pop();
-            return event;
+            return take_front();
         }
         return std::nullopt;
     }
@@ -61,9 +84,7 @@ public:
     std::optional<MQTTEvent> try_pop() {
         std::lock_guard<std::mutex> lock(mutex_);
         if (queue_.empty()) return std::nullopt;
-        auto event = std::move(queue_.front());
-        queue_.pop();
-        return event;
+        return take_front();
     }
 
     bool empty() const {
@@ -78,14 +99,47 @@ public:
 
     void clear() {
         std::lock_guard<std::mutex> lock(mutex_);
-        std::queue<MQTTEvent> empty;
+        std::queue<Entry> empty;
         std::swap(queue_, empty);
+        latest_.clear();
+    }
+
+    // push_latest() 로 교체되어 전달되지 않은 이벤트 수
+    uint64_t conflated() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return conflated_;
     }
 
 private:
+    struct Entry {
+        MQTTEvent event;
+        bool latest;    // true 면 latest_ 에서 토픽의 최신 이벤트를 꺼냄
+    };
+
+    MQTTEvent take_front() {
+        Entry entry = std::move(queue_.front());
+        queue_.pop();
+        MQTTEvent event;
+        if (!entry.latest) {
+            event = std::move(entry.event);
+        } else {
+            auto it = latest_.find(entry.event.topic);
+            event = std::move(it->second);
+            latest_.erase(it);
+        }
+#ifdef MQTT_ENABLE_TRACING
+        if (event.trace.sampled()) {
+            event.trace.dequeued_ns = Tracer::now_ns();
+        }
+#endif
+        return event;
+    }
+
     mutable std::mutex mutex_;
     std::condition_variable cv_;
-    std::queue<MQTTEvent> queue_;
+    std::queue<Entry> queue_;
+    std::unordered_map<std::string, MQTTEvent> latest_;
+    uint64_t conflated_ = 0;
 };
 
 inline const char* event_type_to_string(EventType type) {
@@ -98,6 +152,7 @@ inline const char* event_type_to_string(EventType type) {
         case EventType::SUBSCRIBE_FAILURE: return "SUBSCRIBE_FAILURE";
         case EventType::PUBLISH_SUCCESS: return "PUBLISH_SUCCESS";
         case EventType::PUBLISH_FAILURE: return "PUBLISH_FAILURE";
+        case EventType::SEQUENCE_GAP: return "SEQUENCE_GAP";
         case EventType::ERROR: return "ERROR";
         default: return "UNKNOWN";
     }
@@ -0,0 +1,29 @@
+#pragma once
+
+// 컴파일 시점 기능 선택 - CMake 옵션(MQTT_ENABLE_*)이 0/1 로 정의하며, 직접 빌드 시 기본값은 모두 활성
+// 비활성 기능은 코드와 의존성이 컴파일에서 빠진다 (LOGGING: <iostream>, TLS: OpenSSL / <filesystem>)
+#ifndef MQTT_FEATURE_LOGGING
+    #define MQTT_FEATURE_LOGGING 1       // 진단 로그 (MQTT_LOG)
+#endif
+#ifndef MQTT_FEATURE_TLS
+    #define MQTT_FEATURE_TLS 1           // SSL/TLS, 시스템 인증서 탐색/추출, mTLS
+#endif
+#ifndef MQTT_FEATURE_WEBSOCKETS
+    #define MQTT_FEATURE_WEBSOCKETS 1    // ws:// / wss:// 전송
+#endif
+#ifndef MQTT_FEATURE_HEALTH_CHECK
+    #define MQTT_FEATURE_HEALTH_CHECK 1  // 연결 상태 점검, sleep/resume 감지, 수신 활동 추적
+#endif
+#ifndef MQTT_FEATURE_METRICS
+    #define MQTT_FEATURE_METRICS 1       // 전송량 통계 (ClientStats 송수신 카운터, TopicStats)
+#endif
+
+namespace mqtt_client::features {
+
+inline constexpr bool logging = MQTT_FEATURE_LOGGING != 0;
+inline constexpr bool tls = MQTT_FEATURE_TLS != 0;
+inline constexpr bool websockets = MQTT_FEATURE_WEBSOCKETS != 0;
+inline constexpr bool health_check = MQTT_FEATURE_HEALTH_CHECK != 0;
+inline constexpr bool metrics = MQTT_FEATURE_METRICS != 0;
+
+} // namespace mqtt_client::features
@@ -0,0 +1,260 @@
+#include "flight_recorder.h"
+#include "log.h"
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+
+namespace mqtt_client {
+
+namespace {
+
+constexpr uint8_t kFlagRetained = 1;
+constexpr uint8_t kFlagSnapshot = 2;
+
+int64_t now_us() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void put_u32(char* p, uint32_t value) { std::memcpy(p, &value, 4); }
+
+} // namespace
+
+MQTTEvent JournalRecord::to_event() const {
+    MQTTEvent event(event_type, message);
+    event.topic = topic;
+    event.payload = payload;
+    event.qos = qos;
+    event.token = token;
+    event.retained = retained;
+    event.from_snapshot = from_snapshot;
+    return event;
+}
+
+FlightRecorder::FlightRecorder(std::string path, size_t capacity)
+    : path_(std::move(path)), capacity_(std::max<size_t>(capacity, 64 * 1024)) {}
+
+FlightRecorder::~FlightRecorder() {
+    close();
+}
+
+bool FlightRecorder::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_.is_open()) {
+        return true;
+    }
+    if (!file_.open(path_, sizeof(Header) + capacity_)) {
+        MQTT_LOG_ERROR("[Recorder] Failed to map journal file: " << path_);
+        return false;
+    }
+    auto* header = reinterpret_cast<Header*>(file_.data());
+    if (std::memcmp(header->magic, "MQFR", 4) != 0 || header->version != kVersion ||
+        header->capacity != capacity_ || header->head < header->tail ||
+        header->head - header->tail > capacity_) {
+        std::memcpy(header->magic, "MQFR", 4);
+        header->version = kVersion;
+        header->capacity = capacity_;
+        header->head = 0;
+        header->tail = 0;
+        header->count = 0;
+    }
+    MQTT_LOG("[Recorder] Recording to " << path_ << " (" << capacity_ / 1024 << " KB ring, "
+             << header->count << " existing record(s))");
+    return true;
+}
+
+void FlightRecorder::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.close();
+}
+
+void FlightRecorder::record_event(const MQTTEvent& event) {
+    uint8_t flags = (event.retained ? kFlagRetained : 0) | (event.from_snapshot ? kFlagSnapshot : 0);
+    append(JournalRecord::Kind::EVENT, static_cast<uint8_t>(event.type), event.qos, flags, event.token,
+           event.topic, event.payload, event.message);
+}
+
+void FlightRecorder::record_outbound(JournalRecord::Kind kind, std::string_view topic,
+                                     std::string_view payload, int qos, bool retained) {
+    append(kind, 0, qos, retained ? kFlagRetained : 0, 0, topic, payload, {});
+}
+
+void FlightRecorder::append(JournalRecord::Kind kind, uint8_t event_type, int qos, uint8_t flags, int token,
+                            std::string_view topic, std::string_view payload, std::string_view message) {
+    size_t size = kRecordHeader + topic.size() + payload.size() + message.size();
+    if (size > capacity_ / 2) {
+        oversized_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    char head[kRecordHeader];
+    put_u32(head, static_cast<uint32_t>(size));
+    head[4] = static_cast<char>(kind);
+    head[5] = static_cast<char>(event_type);
+    head[6] = static_cast<char>(qos);
+    head[7] = static_cast<char>(flags);
+    int64_t timestamp = now_us();
+    std::memcpy(head + 8, &timestamp, 8);
+    std::memcpy(head + 16, &token, 4);
+    put_u32(head + 20, static_cast<uint32_t>(topic.size()));
+    put_u32(head + 24, static_cast<uint32_t>(payload.size()));
+    put_u32(head + 28, static_cast<uint32_t>(message.size()));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!file_.is_open()) {
+        return;
+    }
+    auto* header = reinterpret_cast<Header*>(file_.data());
+
+    // 공간 확보 - 가장 오래된 레코드부터 버림
+    uint64_t tail = header->tail;
+    uint64_t count = header->count;
+    while (header->head + size - tail > capacity_) {
+        tail += read_length(tail);
+        --count;
+    }
+    header->tail = tail;
+
+    uint64_t offset = header->head;
+    write_ring(offset, head, kRecordHeader);
+    offset += kRecordHeader;
+    write_ring(offset, topic.data(), topic.size());
+    offset += topic.size();
+    write_ring(offset, payload.data(), payload.size());
+    offset += payload.size();
+    write_ring(offset, message.data(), message.size());
+
+    header->count = count + 1;
+    header->head += size;  // 레코드 기록 후 커밋
+    records_.fetch_add(1, std::memory_order_relaxed);
+}
+
+void FlightRecorder::write_ring(uint64_t offset, const void* data, size_t size) {
+    if (size == 0) {
+        return;
+    }
+    char* ring = file_.data() + sizeof(Header);
+    size_t pos = static_cast<size_t>(offset % capacity_);
+    size_t first = std::min(size, capacity_ - pos);
+    std::memcpy(ring + pos, data, first);
+    std::memcpy(ring, static_cast<const char*>(data) + first, size - first);
+}
+
+uint32_t FlightRecorder::read_length(uint64_t offset) const {
+    const char* ring = file_.data() + sizeof(Header);
+    char bytes[4];
+    for (size_t i = 0; i < 4; ++i) {
+        bytes[i] = ring[(offset + i) % capacity_];
+    }
+    uint32_t length;
+    std::memcpy(&length, bytes, 4);
+    return length;
+}
+
+// ============================================================================
+// 읽기 / 재생
+// ============================================================================
+bool FlightRecorder::read(const std::string& path, const std::function<void(const JournalRecord&)>& fn) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        MQTT_LOG_ERROR("[Recorder] Failed to open journal: " << path);
+        return false;
+    }
+    Header header{};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "MQFR", 4) != 0 || header.version != kVersion ||
+        header.head < header.tail || header.head - header.tail > header.capacity) {
+        MQTT_LOG_ERROR("[Recorder] Not a journal file: " << path);
+        return false;
+    }
+    std::string ring(static_cast<size_t>(header.capacity), '\0');
+    if (!file.seekg(static_cast<std::streamoff>(sizeof(Header))) ||
+        !file.read(&ring[0], static_cast<std::streamsize>(ring.size()))) {
+        MQTT_LOG_ERROR("[Recorder] Truncated journal file: " << path);
+        return false;
+    }
+
+    // 링에서 연속 바이트 읽기 (경계를 넘으면 나누어 복사)
+    auto copy_out = [&ring, &header](uint64_t offset, size_t size) {
+        std::string out(size, '\0');
+        for (size_t done = 0; done < size;) {
+            size_t pos = static_cast<size_t>((offset + done) % header.capacity);
+            size_t chunk = std::min(size - done, static_cast<size_t>(header.capacity) - pos);
+            std::memcpy(&out[done], ring.data() + pos, chunk);
+            done += chunk;
+        }
+        return out;
+    };
+
+    for (uint64_t offset = header.tail; offset < header.head;) {
+        std::string head = copy_out(offset, kRecordHeader);
+        uint32_t size;
+        uint32_t topic_len;
+        uint32_t payload_len;
+        uint32_t message_len;
+        int64_t timestamp;
+        std::memcpy(&size, head.data(), 4);
+        std::memcpy(&timestamp, head.data() + 8, 8);
+        std::memcpy(&topic_len, head.data() + 20, 4);
+        std::memcpy(&payload_len, head.data() + 24, 4);
+        std::memcpy(&message_len, head.data() + 28, 4);
+        if (size < kRecordHeader || offset + size > header.head ||
+            static_cast<uint64_t>(topic_len) + payload_len + message_len + kRecordHeader != size) {
+            MQTT_LOG_ERROR("[Recorder] Corrupt record at offset " << offset);
+            return false;
+        }
+
+        JournalRecord record;
+        record.kind = static_cast<JournalRecord::Kind>(head[4]);
+        record.event_type = static_cast<EventType>(static_cast<uint8_t>(head[5]));
+        record.qos = static_cast<uint8_t>(head[6]);
+        record.retained = (head[7] & kFlagRetained) != 0;
+        record.from_snapshot = (head[7] & kFlagSnapshot) != 0;
+        record.timestamp = std::chrono::system_clock::time_point(std::chrono::microseconds(timestamp));
+        std::memcpy(&record.token, head.data() + 16, 4);
+        uint64_t body = offset + kRecordHeader;
+        record.topic = copy_out(body, topic_len);
+        record.payload = copy_out(body + topic_len, payload_len);
+        record.message = copy_out(body + topic_len + payload_len, message_len);
+        fn(record);
+        offset += size;
+    }
+    return true;
+}
+
+size_t FlightRecorder::replay(const std::string& path, double speed,
+                              const std::function<void(const JournalRecord&)>& fn,
+                              const std::atomic<bool>* cancel) {
+    size_t replayed = 0;
+    bool started = false;
+    std::chrono::system_clock::time_point first_recorded;
+    std::chrono::steady_clock::time_point replay_start;
+
+    read(path, [&](const JournalRecord& record) {
+        if (cancel && cancel->load()) {
+            return;
+        }
+        if (!started) {
+            started = true;
+            first_recorded = record.timestamp;
+            replay_start = std::chrono::steady_clock::now();
+        } else if (speed > 0) {
+            auto offset = std::chrono::duration<double>(record.timestamp - first_recorded) / speed;
+            auto due = replay_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+            // 취소 확인을 위해 나누어 대기
+            while (std::chrono::steady_clock::now() < due && !(cancel && cancel->load())) {
+                std::this_thread::sleep_until(std::min(due, std::chrono::steady_clock::now() +
+                                                            std::chrono::milliseconds(100)));
+            }
+            if (cancel && cancel->load()) {
+                return;
+            }
+        }
+        fn(record);
+        ++replayed;
+    });
+    return replayed;
+}
+
+} // namespace mqtt_client
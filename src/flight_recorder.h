@@ -0,0 +1,93 @@
+#pragma once
+
+#include "client_export.h"
+#include "event_queue.h"
+#include "mapped_file.h"
+#include <string>
+#include <string_view>
+#include <functional>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// 비행 기록기 레코드 (수신/상태 이벤트 또는 송신 작업)
+struct MQTT_CLIENT_API JournalRecord {
+    enum class Kind : uint8_t { EVENT, SUBSCRIBE, PUBLISH, UNSUBSCRIBE };
+
+    Kind kind = Kind::EVENT;
+    std::chrono::system_clock::time_point timestamp;
+    EventType event_type = EventType::ERROR;  // EVENT 일 때만 의미 있음
+    std::string topic;
+    std::string payload;
+    std::string message;
+    int qos = 0;
+    int token = 0;
+    bool retained = false;
+    bool from_snapshot = false;
+
+    MQTTEvent to_event() const;
+};
+
+// 비행 기록기 - 모든 MQTTEvent 와 송신 작업을 메모리 매핑 링 파일에 바이너리로 기록
+//
+// 파일이 가득 차면 가장 오래된 레코드부터 덮어쓴다 (최근 capacity 바이트 분량 유지)
+// 헤더의 head/tail 은 레코드를 다 쓴 뒤 갱신하므로 비정상 종료 후에도 파일을 읽을 수 있다
+// 레코드: [길이 u32][종류 u8][이벤트 타입 u8][QoS u8][플래그 u8][시각 µs i64][토큰 i32]
+//         [토픽 길이 u32][페이로드 길이 u32][메시지 길이 u32][토픽][페이로드][메시지]
+class MQTT_CLIENT_API FlightRecorder {
+public:
+    explicit FlightRecorder(std::string path, size_t capacity = 64 * 1024 * 1024);
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // 기존 기록이 있으면 이어서 기록 (용량이 다르면 새로 시작)
+    bool open();
+    void close();
+    bool is_open() const { return file_.is_open(); }
+
+    void record_event(const MQTTEvent& event);
+    void record_outbound(JournalRecord::Kind kind, std::string_view topic, std::string_view payload,
+                         int qos, bool retained);
+
+    uint64_t records() const { return records_.load(std::memory_order_relaxed); }
+    uint64_t oversized() const { return oversized_.load(std::memory_order_relaxed); }
+
+    // 기록 파일을 오래된 순서로 읽기
+    static bool read(const std::string& path, const std::function<void(const JournalRecord&)>& fn);
+
+    // 기록 간격을 재현하며 재생 (speed 배속, 0 이하면 대기 없이) - 재생한 레코드 수 반환
+    static size_t replay(const std::string& path, double speed,
+                         const std::function<void(const JournalRecord&)>& fn,
+                         const std::atomic<bool>* cancel = nullptr);
+
+private:
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint64_t capacity;  // 링 영역 크기
+        uint64_t head;      // 누적 기록 바이트 (다음 기록 위치)
+        uint64_t tail;      // 가장 오래된 레코드 시작 (누적 오프셋)
+        uint64_t count;     // 링에 남아있는 레코드 수
+    };
+    static constexpr uint32_t kVersion = 1;
+    static constexpr size_t kRecordHeader = 32;
+
+    void append(JournalRecord::Kind kind, uint8_t event_type, int qos, uint8_t flags, int token,
+                std::string_view topic, std::string_view payload, std::string_view message);
+    void write_ring(uint64_t offset, const void* data, size_t size);
+    uint32_t read_length(uint64_t offset) const;
+
+    std::string path_;
+    size_t capacity_;
+    mutable std::mutex mutex_;  // Paho 콜백 스레드와 MQTT 스레드 공유
+    MappedFile file_;
+    std::atomic<uint64_t> records_{0};
+    std::atomic<uint64_t> oversized_{0};
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,307 @@
+#pragma once
+
+#include "topic_filter.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// 토픽별 마지막 값 캐시 (읽기 잠금 없음)
+//
+// 쓰기: 수신 콜백에서 update() - 값은 불변 객체로 만들어 포인터를 교체한다
+// 읽기: get()/visit() - 에포크 기반 회수(EBR)로 보호되어 잠금/할당 없이 읽는다
+//   리더는 스레드별 슬롯에 현재 에포크를 알리고, 교체된 값은 그 에포크를 지난
+//   모든 리더가 빠져나간 뒤에 해제된다 (스레드당 첫 읽기에서만 슬롯 등록 잠금)
+// 토픽 인덱스는 삽입 전용 개방 주소 해시라 리더와 동시에 추가할 수 있고,
+// 부하율이 넘으면 새 테이블로 교체한다
+class LastValueCache {
+public:
+    struct Value {
+        std::string payload;
+        std::chrono::system_clock::time_point updated;
+    };
+
+    // filters 가 비어 있으면 모든 수신 토픽을 캐시
+    explicit LastValueCache(std::vector<std::string> filters = {})
+        : filters_(std::move(filters)), id_(next_id()) {
+        table_.store(new Table(64));
+    }
+
+    ~LastValueCache() {
+        for (auto& cell : cells_) {
+            delete cell->value.load();
+        }
+        for (auto& retired : retired_) {
+            delete retired.value;
+            delete retired.table;
+        }
+        delete table_.load();
+    }
+
+    LastValueCache(const LastValueCache&) = delete;
+    LastValueCache& operator=(const LastValueCache&) = delete;
+
+    bool accepts(std::string_view topic) const {
+        if (filters_.empty()) {
+            return true;
+        }
+        for (const auto& filter : filters_) {
+            if (topic_matches(filter, topic)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ---- 쓰기 (수신 스레드) ----
+    void update(std::string_view topic, std::string_view payload) {
+        auto* value = new Value{std::string(payload), std::chrono::system_clock::now()};
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        Cell* cell = find_or_insert(topic);
+        retire(cell->value.exchange(value), nullptr);
+    }
+
+    void erase(std::string_view topic) {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        Cell* cell = const_cast<Cell*>(find(topic_hash(topic), topic));
+        if (cell) {
+            retire(cell->value.exchange(nullptr), nullptr);
+        }
+    }
+
+    // ---- 읽기 (임의 스레드, 잠금 없음) ----
+    std::optional<std::string> get(std::string_view topic) const {
+        std::optional<std::string> result;
+        visit(topic, [&result](std::string_view payload, std::chrono::system_clock::time_point) {
+            result.emplace(payload);
+        });
+        return result;
+    }
+
+    // 복사 없이 읽기 - fn(std::string_view payload, time_point updated) 는 보호 구간 안에서 호출됨
+    template <typename Fn>
+    bool visit(std::string_view topic, Fn&& fn) const {
+        ReadGuard guard(*this);
+        const Cell* cell = find(topic_hash(topic), topic);
+        if (!cell) {
+            return false;
+        }
+        const Value* value = cell->value.load();
+        if (!value) {
+            return false;
+        }
+        fn(std::string_view(value->payload), value->updated);
+        return true;
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        size_t count = 0;
+        for (const auto& cell : cells_) {
+            count += cell->value.load() != nullptr;
+        }
+        return count;
+    }
+
+private:
+    struct Cell {
+        std::string topic;
+        uint64_t hash;
+        std::atomic<const Value*> value{nullptr};
+    };
+
+    struct Table {
+        explicit Table(size_t capacity)
+            : mask(capacity - 1), buckets(new std::atomic<const Cell*>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i) {
+                buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        size_t mask;
+        std::unique_ptr<std::atomic<const Cell*>[]> buckets;
+        size_t count = 0;  // 쓰기 측 전용
+    };
+
+    struct alignas(64) ReaderSlot {
+        std::atomic<uint64_t> epoch{0};  // 0 = 읽는 중 아님
+        std::atomic<bool> in_use{true};
+        int depth = 0;                   // 소유 스레드 전용 (중첩 읽기)
+    };
+
+    struct Retired {
+        uint64_t epoch;
+        const Value* value;
+        const Table* table;
+    };
+
+    // 스레드 종료 시 슬롯을 반납해 다른 스레드가 재사용
+    struct ThreadSlots {
+        std::vector<std::pair<uint64_t, std::shared_ptr<ReaderSlot>>> slots;
+        ~ThreadSlots() {
+            for (auto& entry : slots) {
+                entry.second->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    class ReadGuard {
+    public:
+        explicit ReadGuard(const LastValueCache& cache) : slot_(cache.reader_slot()) {
+            if (slot_->depth++ == 0) {
+                slot_->epoch.store(cache.epoch_.load());
+            }
+        }
+        ~ReadGuard() {
+            if (--slot_->depth == 0) {
+                slot_->epoch.store(0, std::memory_order_release);
+            }
+        }
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        ReaderSlot* slot_;
+    };
+
+    static constexpr size_t kReclaimThreshold = 64;
+
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> counter{1};
+        return counter.fetch_add(1);
+    }
+
+    ReaderSlot* reader_slot() const {
+        thread_local ThreadSlots local;
+        for (const auto& [id, slot] : local.slots) {
+            if (id == id_) {
+                return slot.get();
+            }
+        }
+
+        std::shared_ptr<ReaderSlot> slot;
+        {
+            std::lock_guard<std::mutex> lock(slots_mutex_);
+            for (const auto& candidate : reader_slots_) {
+                bool expected = false;
+                if (candidate->in_use.compare_exchange_strong(expected, true)) {
+                    slot = candidate;
+                    break;
+                }
+            }
+            if (!slot) {
+                slot = std::make_shared<ReaderSlot>();
+                reader_slots_.push_back(slot);
+            }
+        }
+        // 소멸된 캐시의 슬롯 정리 (캐시가 더 이상 참조하지 않음)
+        for (auto it = local.slots.begin(); it != local.slots.end();) {
+            it = it->second.use_count() == 1 ? local.slots.erase(it) : it + 1;
+        }
+        local.slots.emplace_back(id_, slot);
+        return slot.get();
+    }
+
+    const Cell* find(uint64_t hash, std::string_view topic) const {
+        const Table* table = table_.load();
+        for (size_t pos = hash & table->mask;; pos = (pos + 1) & table->mask) {
+            const Cell* cell = table->buckets[pos].load(std::memory_order_acquire);
+            if (!cell) {
+                return nullptr;
+            }
+            if (cell->hash == hash && cell->topic == topic) {
+                return cell;
+            }
+        }
+    }
+
+    static void insert(Table& table, const Cell* cell) {
+        size_t pos = cell->hash & table.mask;
+        while (table.buckets[pos].load(std::memory_order_relaxed)) {
+            pos = (pos + 1) & table.mask;
+        }
+        table.buckets[pos].store(cell, std::memory_order_release);
+        ++table.count;
+    }
+
+    // write_mutex_ 보유 상태에서 호출
+    Cell* find_or_insert(std::string_view topic) {
+        uint64_t hash = topic_hash(topic);
+        if (const Cell* cell = find(hash, topic)) {
+            return const_cast<Cell*>(cell);
+        }
+
+        cells_.push_back(std::make_unique<Cell>());
+        Cell* cell = cells_.back().get();
+        cell->topic = std::string(topic);
+        cell->hash = hash;
+
+        Table* table = const_cast<Table*>(table_.load());
+        if ((table->count + 1) * 2 > table->mask + 1) {
+            auto* grown = new Table((table->mask + 1) * 2);
+            for (const auto& existing : cells_) {
+                insert(*grown, existing.get());
+            }
+            retire(nullptr, table_.exchange(grown));
+        } else {
+            insert(*table, cell);
+        }
+        return cell;
+    }
+
+    // write_mutex_ 보유 상태에서 호출
+    void retire(const Value* value, const Table* table) {
+        if (!value && !table) {
+            return;
+        }
+        // 교체 이후 에포크를 올림 → 이보다 큰 에포크로 들어온 리더는 새 포인터만 본다
+        retired_.push_back(Retired{epoch_.fetch_add(1), value, table});
+        if (retired_.size() >= kReclaimThreshold) {
+            reclaim();
+        }
+    }
+
+    void reclaim() {
+        uint64_t min_active = UINT64_MAX;
+        {
+            std::lock_guard<std::mutex> lock(slots_mutex_);
+            for (const auto& slot : reader_slots_) {
+                uint64_t epoch = slot->epoch.load();
+                if (epoch != 0 && epoch < min_active) {
+                    min_active = epoch;
+                }
+            }
+        }
+        size_t kept = 0;
+        for (auto& retired : retired_) {
+            if (retired.epoch < min_active) {
+                delete retired.value;
+                delete retired.table;
+            } else {
+                retired_[kept++] = retired;
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    std::vector<std::string> filters_;
+    uint64_t id_;
+
+    std::atomic<uint64_t> epoch_{1};
+    std::atomic<const Table*> table_{nullptr};
+
+    mutable std::mutex write_mutex_;
+    std::vector<std::unique_ptr<Cell>> cells_;
+    std::vector<Retired> retired_;
+
+    mutable std::mutex slots_mutex_;  // 슬롯 등록 / 회수 시 스캔
+    mutable std::vector<std::shared_ptr<ReaderSlot>> reader_slots_;
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,345 @@
+#include "mqtt_client.h"
+#include <iostream>
+#include <csignal>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <set>
+#include <unordered_map>
+#include <algorithm>
+
+using namespace mqtt_client;
+
+// 기록 파일(--record 로 생성한 비행 기록)을 로컬 브로커에 다시 발행하는 부하 생성기
+// 발행 클라이언트가 기록된 간격(배속 적용)으로 발행하고, 측정 대상 클라이언트가
+// 같은 토픽을 구독해 처리량 / 지연 / 누락 / 이벤트 큐 적체를 측정한다
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signal_handler(int) {
+    g_running.store(false);
+}
+
+using Clock = std::chrono::steady_clock;
+
+struct CaptureMessage {
+    std::chrono::system_clock::time_point timestamp;
+    std::string topic;
+    std::string payload;
+    int qos;
+};
+
+// 이벤트 큐에서 지정한 이벤트가 올 때까지 대기
+bool wait_for(EventQueue& queue, EventType type, int count, std::chrono::seconds timeout) {
+    auto deadline = Clock::now() + timeout;
+    while (count > 0 && g_running.load() && Clock::now() < deadline) {
+        auto event = queue.pop(std::chrono::milliseconds(100));
+        if (!event.has_value()) {
+            continue;
+        }
+        if (event->type == type) {
+            --count;
+        } else if (event->type == EventType::ERROR || event->type == EventType::SUBSCRIBE_FAILURE) {
+            std::cerr << "[LoadGen] " << event_type_to_string(event->type) << ": " << event->message << std::endl;
+        }
+    }
+    return count == 0;
+}
+
+double percentile(std::vector<int64_t>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1));
+    return static_cast<double>(sorted[index]) / 1000.0;
+}
+
+void print_usage() {
+    std::cout << R"(
+Usage:
+  mqtt_loadgen [options] --capture FILE [broker_host] [port]
+
+Replays the MESSAGE_ARRIVED events and outbound PUBLISH requests of a capture
+(recorded with mqtt_client_test --record) against a broker and measures how a
+subscribing MQTTClient keeps up.
+
+Options:
+  --capture FILE  Flight recorder file to replay (required)
+  --speed X       Rate multiplier (default 1.0, 0 = as fast as possible)
+  --repeat N      Replay the capture N times (default 1)
+  --drain SEC     Time to wait for outstanding messages after the last publish (default 5)
+  --ws / --tcp    Transport (default tcp)
+  --ssl / --no-ssl  TLS (default no-ssl)
+  --cert PATH     Custom certificate file
+  --max-allocs-per-msg N  Fail (exit 3) if client allocations per published message
+                          exceed N (requires -DMQTT_ENABLE_ALLOC_TRACKING=ON)
+  -h, --help      Show this help
+
+Defaults to a local broker at localhost:1883.
+)" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signal_handler);
+    std::signal(SIGTERM, signal_handler);
+
+    MQTTConfig config;
+    config.use_websockets = false;
+    config.use_ssl = false;
+    std::string capture_file;
+    double speed = 1.0;
+    int repeat = 1;
+    int drain_seconds = 5;
+    double max_allocs_per_message = -1.0;  // 음수면 검사 안 함
+    std::string broker_host;
+    int broker_port = 0;
+
+    int arg_idx = 1;
+    while (arg_idx < argc) {
+        std::string arg = argv[arg_idx];
+        if (arg == "--capture" && arg_idx + 1 < argc) {
+            capture_file = argv[arg_idx + 1];
+            arg_idx += 2;
+        } else if (arg == "--speed" && arg_idx + 1 < argc) {
+            speed = std::atof(argv[arg_idx + 1]);
+            arg_idx += 2;
+        } else if (arg == "--repeat" && arg_idx + 1 < argc) {
+            repeat = std::max(1, std::atoi(argv[arg_idx + 1]));
+            arg_idx += 2;
+        } else if (arg == "--drain" && arg_idx + 1 < argc) {
+            drain_seconds = std::max(0, std::atoi(argv[arg_idx + 1]));
+            arg_idx += 2;
+        } else if (arg == "--ws") {
+            config.use_websockets = true;
+            arg_idx++;
+        } else if (arg == "--tcp") {
+            config.use_websockets = false;
+            arg_idx++;
+        } else if (arg == "--ssl") {
+            config.use_ssl = true;
+            arg_idx++;
+        } else if (arg == "--no-ssl") {
+            config.use_ssl = false;
+            arg_idx++;
+        } else if (arg == "--cert" && arg_idx + 1 < argc) {
+            config.cert_file_path = argv[arg_idx + 1];
+            arg_idx += 2;
+        } else if (arg == "--max-allocs-per-msg" && arg_idx + 1 < argc) {
+            max_allocs_per_message = std::atof(argv[arg_idx + 1]);
+            arg_idx += 2;
+        } else if (arg == "-h" || arg == "--help") {
+            print_usage();
+            return 0;
+        } else {
+            if (broker_host.empty()) {
+                broker_host = arg;
+            } else if (broker_port == 0) {
+                broker_port = std::atoi(arg.c_str());
+            }
+            arg_idx++;
+        }
+    }
+    if (capture_file.empty()) {
+        print_usage();
+        return 1;
+    }
+
+    // 캡처 읽기 - 수신 메시지와 송신 발행 모두 트래픽 구성에 포함
+    std::vector<CaptureMessage> capture;
+    std::set<std::string> topics;
+    bool read_ok = FlightRecorder::read(capture_file, [&](const JournalRecord& record) {
+        bool inbound = record.kind == JournalRecord::Kind::EVENT &&
+                       record.event_type == EventType::MESSAGE_ARRIVED && !record.from_snapshot;
+        if (inbound || record.kind == JournalRecord::Kind::PUBLISH) {
+            capture.push_back({record.timestamp, record.topic, record.payload, record.qos});
+            topics.insert(record.topic);
+        }
+    });
+    if (!read_ok || capture.empty()) {
+        std::cerr << "[LoadGen] No messages to replay in " << capture_file << std::endl;
+        return 1;
+    }
+    size_t capture_bytes = 0;
+    for (const auto& message : capture) {
+        capture_bytes += message.payload.size();
+    }
+    auto capture_span = std::chrono::duration<double>(capture.back().timestamp - capture.front().timestamp);
+    std::cout << "[LoadGen] " << capture.size() << " message(s), " << topics.size() << " topic(s), "
+              << capture_bytes << " payload bytes over " << capture_span.count() << " s" << std::endl;
+
+    config.broker_host = broker_host.empty() ? "localhost" : broker_host;
+    config.broker_port = broker_port == 0 ? config.get_default_port() : broker_port;
+    config.keep_alive_seconds = 20;
+    config.connection_check_interval_ms = 1000;
+
+    MQTTConfig publisher_config = config;
+    publisher_config.client_id = "mqtt_loadgen_pub";
+    MQTTConfig subscriber_config = config;
+    subscriber_config.client_id = "mqtt_loadgen_sub";
+
+    EventQueue publisher_queue;
+    EventQueue subscriber_queue;
+    MQTTClient publisher(publisher_config, publisher_queue);
+    MQTTClient subscriber(subscriber_config, subscriber_queue);
+    std::thread publisher_thread([&publisher]() { publisher.run(); });
+    std::thread subscriber_thread([&subscriber]() { subscriber.run(); });
+
+    auto shutdown = [&]() {
+        publisher.stop();
+        subscriber.stop();
+        publisher_thread.join();
+        subscriber_thread.join();
+    };
+
+    if (!wait_for(publisher_queue, EventType::CONNECTED, 1, std::chrono::seconds(30)) ||
+        !wait_for(subscriber_queue, EventType::CONNECTED, 1, std::chrono::seconds(30))) {
+        std::cerr << "[LoadGen] Failed to connect to " << config.broker_host << ":" << config.broker_port << std::endl;
+        shutdown();
+        return 1;
+    }
+    for (const auto& topic : topics) {
+        subscriber.request_subscribe(topic, 1);
+    }
+    if (!wait_for(subscriber_queue, EventType::SUBSCRIBE_SUCCESS, static_cast<int>(topics.size()),
+                  std::chrono::seconds(30))) {
+        std::cerr << "[LoadGen] Subscriptions did not complete" << std::endl;
+        shutdown();
+        return 1;
+    }
+
+    // 토픽별 발행 시각 FIFO - 단일 발행자의 토픽 내 순서는 보존되므로 수신 순서로 짝을 맞춘다
+    // (QoS 0 메시지가 유실되면 해당 토픽의 이후 지연 값이 어긋날 수 있음)
+    std::mutex pending_mutex;
+    std::unordered_map<std::string, std::deque<Clock::time_point>> pending;
+    std::vector<int64_t> latencies_us;
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> unmatched{0};
+    std::atomic<size_t> max_queue_depth{0};
+    std::atomic<bool> consuming{true};
+
+    // 측정 대상 - 구독 클라이언트의 이벤트 큐를 소비
+    std::thread consumer([&]() {
+        while (consuming.load()) {
+            size_t depth = subscriber_queue.size();
+            if (depth > max_queue_depth.load(std::memory_order_relaxed)) {
+                max_queue_depth.store(depth, std::memory_order_relaxed);
+            }
+            auto event = subscriber_queue.pop(std::chrono::milliseconds(100));
+            if (!event.has_value() || event->type != EventType::MESSAGE_ARRIVED) {
+                continue;
+            }
+            auto now = Clock::now();
+            received.fetch_add(1, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(pending_mutex);
+            auto it = pending.find(event->topic);
+            if (it == pending.end() || it->second.empty()) {
+                unmatched.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            latencies_us.push_back(std::chrono::duration_cast<std::chrono::microseconds>(
+                now - it->second.front()).count());
+            it->second.pop_front();
+        }
+    });
+
+    // 원래 간격(배속 적용)으로 발행
+    std::cout << "[LoadGen] Replaying at " << speed << "x, " << repeat << " pass(es)..." << std::endl;
+    uint64_t published = 0;
+    int64_t max_schedule_lag_us = 0;
+    reset_allocation_stats();  // 연결/구독 준비 중 할당 제외
+    auto replay_start = Clock::now();
+    for (int pass = 0; pass < repeat && g_running.load(); ++pass) {
+        auto pass_start = Clock::now();
+        for (const auto& message : capture) {
+            if (!g_running.load()) {
+                break;
+            }
+            auto due = pass_start;
+            if (speed > 0) {
+                auto offset = std::chrono::duration<double>(message.timestamp - capture.front().timestamp) / speed;
+                due += std::chrono::duration_cast<Clock::duration>(offset);
+                std::this_thread::sleep_until(due);
+            }
+            auto now = Clock::now();
+            max_schedule_lag_us = std::max<int64_t>(max_schedule_lag_us,
+                std::chrono::duration_cast<std::chrono::microseconds>(now - due).count());
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex);
+                pending[message.topic].push_back(now);
+            }
+            publisher.request_publish(message.topic, message.payload, message.qos, false);
+            ++published;
+        }
+    }
+    auto publish_elapsed = std::chrono::duration<double>(Clock::now() - replay_start);
+
+    // 미수신 메시지 대기
+    auto drain_deadline = Clock::now() + std::chrono::seconds(drain_seconds);
+    while (g_running.load() && received.load() - unmatched.load() < published && Clock::now() < drain_deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    auto total_elapsed = std::chrono::duration<double>(Clock::now() - replay_start);
+    consuming.store(false);
+    consumer.join();
+
+    auto publisher_stats = publisher.get_stats();
+    auto subscriber_stats = subscriber.get_stats();
+    shutdown();
+
+    std::sort(latencies_us.begin(), latencies_us.end());
+    uint64_t received_count = received.load();
+    uint64_t matched = latencies_us.size();  // 브로커에 남아있던 retained 등 짝이 없는 수신 제외
+    std::cout << "\n[LoadGen] Report:" << std::endl;
+    std::cout << "  Published: " << published << " msgs in " << publish_elapsed.count() << " s ("
+              << (publish_elapsed.count() > 0 ? published / publish_elapsed.count() : 0.0) << " msg/s)"
+              << ", max schedule lag: " << max_schedule_lag_us / 1000.0 << " ms" << std::endl;
+    std::cout << "  Received: " << received_count << " msgs ("
+              << (total_elapsed.count() > 0 ? received_count / total_elapsed.count() : 0.0) << " msg/s)"
+              << ", missing: " << (published > matched ? published - matched : 0)
+              << ", unmatched: " << unmatched.load() << std::endl;
+    std::cout << "  Latency (ms): p50 " << percentile(latencies_us, 0.50)
+              << " / p99 " << percentile(latencies_us, 0.99)
+              << " / max " << percentile(latencies_us, 1.0) << std::endl;
+    std::cout << "  Subscriber queue peak: " << max_queue_depth.load() << " event(s)" << std::endl;
+    std::cout << "  Wire: sent " << publisher_stats.bytes_sent << " bytes, received "
+              << subscriber_stats.bytes_received << " bytes" << std::endl;
+
+    // 클라이언트 경로 할당 (발행자 + 구독자, OTHER 제외)
+#ifdef MQTT_ENABLE_ALLOC_TRACKING
+    uint64_t client_allocations = 0;
+    std::cout << "  Allocations per message:";
+    for (size_t i = 0; i < subscriber_stats.allocations.size(); ++i) {
+        const auto& counter = subscriber_stats.allocations[i];
+        if (static_cast<AllocSite>(i) != AllocSite::OTHER) {
+            client_allocations += counter.allocations;
+        }
+        std::cout << " " << alloc_site_to_string(static_cast<AllocSite>(i)) << " "
+                  << (published > 0 ? static_cast<double>(counter.allocations) / published : 0.0)
+                  << " (" << (published > 0 ? counter.bytes / published : 0) << " B)";
+    }
+    std::cout << std::endl;
+#endif
+    if (matched < published) {
+        return 2;
+    }
+    if (max_allocs_per_message >= 0) {
+#ifdef MQTT_ENABLE_ALLOC_TRACKING
+        double per_message = published > 0 ? static_cast<double>(client_allocations) / published : 0.0;
+        if (per_message > max_allocs_per_message) {
+            std::cerr << "[LoadGen] Allocation budget exceeded: " << per_message
+                      << " > " << max_allocs_per_message << " per message" << std::endl;
+            return 3;
+        }
+#else
+        std::cerr << "[LoadGen] --max-allocs-per-msg ignored (built without MQTT_ENABLE_ALLOC_TRACKING)" << std::endl;
+#endif
+    }
+    return 0;
+}
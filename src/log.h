@@ -0,0 +1,14 @@
+#pragma once
+
+#include "feature_config.h"
+
+// 라이브러리 진단 로그 - MQTT_LOG("[Tag] text " << value)
+// MQTT_FEATURE_LOGGING 이 0 이면 인자를 평가하지 않으며 <iostream> 도 포함하지 않는다
+#if MQTT_FEATURE_LOGGING
+    #include <iostream>
+    #define MQTT_LOG(message) do { std::cout << message << std::endl; } while (0)
+    #define MQTT_LOG_ERROR(message) do { std::cerr << message << std::endl; } while (0)
+#else
+    #define MQTT_LOG(message) do { } while (0)
+    #define MQTT_LOG_ERROR(message) do { } while (0)
+#endif
@@ -1,4 +1,5 @@
 #include "mqtt_client.h"
+#include "rpc_client.h"
 #include <iostream>
 #include <csignal>
 #include <atomic>
@@ -59,7 +60,8 @@ private:
         // 구독 요청
         client_.request_subscribe("test/topic", 1);
         client_.request_subscribe("system/status", 1);
-        client_.request_subscribe("control/stop", 1);  // 종료 명령 토픽
+        // 종료 명령 토픽 - "shutdown" 외의 페이로드는 수신 경로에서 버림
+        client_.request_subscribe("control/stop", 1, DeliveryPolicy::all().where(payload_equals("shutdown")));
         return true;
     }
     
@@ -84,8 +86,15 @@ private:
         
         // Echo 응답 (테스트용)
         if (topic == "test/topic") {
-            std::string response = "Echo: " + payload;
-            client_.request_publish("test/response", response, 1, false);
+            if (auto request = RpcClient::parse_request(payload)) {
+                // RPC 요청이면 요청자의 응답 토픽으로 회신
+                client_.request_publish(request->reply_topic,
+                                        RpcClient::make_reply(request.value(), "Echo: " + request->body),
+                                        1, false);
+            } else {
+                std::string response = "Echo: " + payload;
+                client_.request_publish("test/response", response, 1, false);
+            }
         }
         
         return true;  // 계속 실행
@@ -132,6 +141,13 @@ Options:
   --ssl        Use SSL/TLS (default)
   --no-ssl     Disable SSL/TLS (insecure)
   --cert PATH  Custom certificate file
+  --client-cert PATH  Client certificate for mTLS (PEM/DER)
+  --client-key PATH   Client private key for mTLS (PEM/DER)
+  --proxy URL  HTTP proxy (http://[user:pass@]host:port)
+  --snapshot FILE  Restore session/queues on start and save them on exit
+  --record FILE    Record events and outbound requests to a flight recorder file
+  --replay FILE    Replay a recorded file through the event handler (no broker connection)
+  --replay-speed X Replay speed multiplier (default 1.0, 0 = as fast as possible)
   -h, --help   Show this help
 
 Examples:
@@ -150,6 +166,10 @@ Examples:
   # With custom certificate
   mqtt_client_test --cert ca.crt broker.example.com 8883
 
+  # Record a session, then replay it at 10x speed
+  mqtt_client_test --record session.mqfr test.mosquitto.org 8883
+  mqtt_client_test --replay session.mqfr --replay-speed 10
+
 Protocol Combinations:
   WebSocket + SSL     = wss://   (Port 8883, 443)
   WebSocket + No SSL  = ws://    (Port 8080, 8083)
@@ -185,6 +205,10 @@ int main(int argc, char* argv[]) {
         
         std::string broker_host;
         int broker_port = 0;
+        std::string snapshot_file;
+        std::string record_file;
+        std::string replay_file;
+        double replay_speed = 1.0;
         
         // 인증서 파일 (선택사항)
         int arg_idx = 1;
@@ -206,6 +230,28 @@ int main(int argc, char* argv[]) {
             } else if (arg == "--cert" && arg_idx + 1 < argc) {
                 config.cert_file_path = argv[arg_idx + 1];
                 arg_idx += 2;
+            } else if (arg == "--client-cert" && arg_idx + 1 < argc) {
+                config.client_cert_file = argv[arg_idx + 1];
+                arg_idx += 2;
+            } else if (arg == "--client-key" && arg_idx + 1 < argc) {
+                config.client_key_file = argv[arg_idx + 1];
+                arg_idx += 2;
+            } else if (arg == "--proxy" && arg_idx + 1 < argc) {
+                config.http_proxy = argv[arg_idx + 1];
+                config.https_proxy = argv[arg_idx + 1];
+                arg_idx += 2;
+            } else if (arg == "--snapshot" && arg_idx + 1 < argc) {
+                snapshot_file = argv[arg_idx + 1];
+                arg_idx += 2;
+            } else if (arg == "--record" && arg_idx + 1 < argc) {
+                record_file = argv[arg_idx + 1];
+                arg_idx += 2;
+            } else if (arg == "--replay" && arg_idx + 1 < argc) {
+                replay_file = argv[arg_idx + 1];
+                arg_idx += 2;
+            } else if (arg == "--replay-speed" && arg_idx + 1 < argc) {
+                replay_speed = std::atof(argv[arg_idx + 1]);
+                arg_idx += 2;
             } else if (arg == "-h" || arg == "--help") {
                 print_usage();
                 return 0;
@@ -251,6 +297,9 @@ int main(int argc, char* argv[]) {
         } else if (config.use_ssl) {
             std::cout << "  Certificate: System certificates" << std::endl;
         }
+        if (config.client_cert_file.has_value()) {
+            std::cout << "  Client Certificate: " << config.client_cert_file.value() << std::endl;
+        }
         
         if (!config.use_ssl) {
             std::cout << "\n  ⚠️  WARNING: SSL/TLS is disabled - connection is NOT secure!" << std::endl;
@@ -262,14 +311,46 @@ int main(int argc, char* argv[]) {
         EventQueue event_queue;
         // MQTT 클라이언트 생성
         MQTTClient mqtt_client(config, event_queue);
+        if (!snapshot_file.empty()) {
+            mqtt_client.load_snapshot(snapshot_file);
+        }
+        auto topic_stats = std::make_shared<TopicStats>();
+        mqtt_client.set_topic_stats(topic_stats);
+        if (!record_file.empty()) {
+            mqtt_client.set_flight_recorder(std::make_shared<FlightRecorder>(record_file));
+        }
         // 이벤트 핸들러 생성
         EventHandler event_handler(mqtt_client);
         
-        // MQTT 스레드 시작
-        std::cout << "[Main] Starting MQTT thread..." << std::endl;
-        std::thread mqtt_thread([&mqtt_client]() {
-            mqtt_client.run();
-        });
+        std::thread mqtt_thread;
+        std::thread replay_thread;
+        std::atomic<bool> replay_done{false};
+        std::atomic<bool> replay_cancel{false};
+        if (replay_file.empty()) {
+            // MQTT 스레드 시작
+            std::cout << "[Main] Starting MQTT thread..." << std::endl;
+            mqtt_thread = std::thread([&mqtt_client]() {
+                mqtt_client.run();
+            });
+        } else {
+            // 재생 모드 - 브로커 연결 없이 기록된 이벤트를 원래 간격(배속 적용)으로 큐에 넣음
+            std::cout << "[Main] Replaying " << replay_file << " at " << replay_speed << "x..." << std::endl;
+            replay_thread = std::thread([&]() {
+                size_t count = FlightRecorder::replay(replay_file, replay_speed,
+                    [&event_queue](const JournalRecord& record) {
+                        if (record.kind == JournalRecord::Kind::EVENT) {
+                            event_queue.push(record.to_event());
+                        } else {
+                            std::cout << "[Replay] Outbound " 
+                                      << (record.kind == JournalRecord::Kind::PUBLISH ? "PUBLISH" :
+                                          record.kind == JournalRecord::Kind::SUBSCRIBE ? "SUBSCRIBE" : "UNSUBSCRIBE")
+                                      << " " << record.topic << std::endl;
+                        }
+                    }, &replay_cancel);
+                std::cout << "[Replay] Replayed " << count << " record(s)" << std::endl;
+                replay_done.store(true);
+            });
+        }
         
         // Main 루프 - 이벤트 처리
         std::cout << "[Main] Entering event loop..." << std::endl;
@@ -286,11 +367,14 @@ int main(int argc, char* argv[]) {
                 event_count++;
                 // 이벤트 핸들러에서 처리
                 bool should_continue = event_handler.handle_event(event.value());
+                mqtt_client.trace_handled(event.value());
                 // false 반환 시 종료
                 if (!should_continue) {
                     g_running.store(false);
                     break;
                 }
+            } else if (replay_done.load() && event_queue.empty()) {
+                break;  // 재생 완료
             }
             // 주기적인 상태 출력 (30초마다)
             auto now = std::chrono::steady_clock::now();
@@ -302,6 +386,17 @@ int main(int argc, char* argv[]) {
                 std::cout << "  Events processed: " << event_count << std::endl;
                 std::cout << "  Queue size: " << event_queue.size() << std::endl;
                 std::cout << "  Protocol: " << config.get_protocol_string() << "://" << std::endl;
+                auto stats = mqtt_client.get_stats();
+                std::cout << "  Connects: " << stats.connect_count
+                          << " (last handshake: " << stats.last_connect_time.count() << " ms"
+                          << (stats.last_connect_via_proxy ? ", via proxy" : ", direct") << ")" << std::endl;
+                std::cout << "  Sent: " << stats.messages_sent << " msgs / " << stats.bytes_sent << " bytes"
+                          << ", Received: " << stats.messages_received << " msgs / "
+                          << stats.bytes_received << " bytes" << std::endl;
+                for (const auto& entry : topic_stats->top(TopicStats::Direction::INBOUND,
+                                                          TopicStats::Metric::BYTES, 3)) {
+                    std::cout << "  Top inbound: " << entry.topic << " (" << entry.count << " bytes)" << std::endl;
+                }
                 std::cout << std::endl;
                 
                 last_status_time = now;
@@ -321,6 +416,13 @@ int main(int argc, char* argv[]) {
         if (mqtt_thread.joinable()) {
             mqtt_thread.join();
         }
+        replay_cancel.store(true);
+        if (replay_thread.joinable()) {
+            replay_thread.join();
+        }
+        if (!snapshot_file.empty()) {
+            mqtt_client.save_snapshot(snapshot_file);
+        }
         
         std::cout << "[Main] Cleanup completed" << std::endl;
         std::cout << "[Main] Total events processed: " << event_count << std::endl;
@@ -0,0 +1,121 @@
+#include "mapped_file.h"
+#include <algorithm>
+#include <cstdint>
+
+#ifdef _WIN32
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace mqtt_client {
+
+bool MappedFile::open(const std::string& path, size_t size) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ,
+                              nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    file_ = file;
+#else
+    fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0600);
+    if (fd_ < 0) {
+        return false;
+    }
+#endif
+    if (!map(size)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::remap(size_t size) {
+    unmap();
+    return map(size);
+}
+
+void MappedFile::close() {
+    unmap();
+#ifdef _WIN32
+    if (file_) {
+        CloseHandle(static_cast<HANDLE>(file_));
+        file_ = nullptr;
+    }
+#else
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+#endif
+}
+
+void MappedFile::flush() {
+    if (!data_) {
+        return;
+    }
+#ifdef _WIN32
+    FlushViewOfFile(data_, 0);
+#else
+    msync(data_, size_, MS_ASYNC);
+#endif
+}
+
+bool MappedFile::map(size_t size) {
+#ifdef _WIN32
+    LARGE_INTEGER current{};
+    GetFileSizeEx(static_cast<HANDLE>(file_), &current);
+    size = std::max(size, static_cast<size_t>(current.QuadPart));
+    HANDLE mapping = CreateFileMappingA(static_cast<HANDLE>(file_), nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+                                        static_cast<DWORD>(size & 0xffffffffu), nullptr);
+    if (!mapping) {
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_ = mapping;
+#else
+    struct stat st{};
+    if (fstat(fd_, &st) != 0) {
+        return false;
+    }
+    size = std::max(size, static_cast<size_t>(st.st_size));
+    if (static_cast<size_t>(st.st_size) < size && ftruncate(fd_, static_cast<off_t>(size)) != 0) {
+        return false;
+    }
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (view == MAP_FAILED) {
+        return false;
+    }
+#endif
+    data_ = static_cast<char*>(view);
+    size_ = size;
+    return true;
+}
+
+void MappedFile::unmap() {
+    if (!data_) {
+        return;
+    }
+    flush();
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+    CloseHandle(static_cast<HANDLE>(mapping_));
+    mapping_ = nullptr;
+#else
+    munmap(data_, size_);
+#endif
+    data_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace mqtt_client
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "client_export.h"
+#include <string>
+#include <cstddef>
+
+namespace mqtt_client {
+
+// 읽기/쓰기 메모리 매핑 파일 (POSIX mmap / Windows 파일 매핑)
+// 파일이 요청 크기보다 작으면 확장하고, 더 크면 파일 크기 전체를 매핑한다
+class MQTT_CLIENT_API MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path, size_t size);
+    // 매핑을 해제하고 더 큰 크기로 다시 매핑 (기존 포인터 무효화)
+    bool remap(size_t size);
+    void close();
+    // 변경 내용을 디스크에 비동기로 기록 요청
+    void flush();
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool is_open() const { return data_ != nullptr; }
+
+private:
+    bool map(size_t size);
+    void unmap();
+
+    char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#else
+    int fd_ = -1;
+#endif
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,164 @@
+#pragma once
+
+#include "event_queue.h"
+#include "topic_filter.h"
+#include <string>
+#include <string_view>
+#include <optional>
+#include <memory>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <shared_mutex>
+#include <functional>
+
+namespace mqtt_client {
+
+// 페이로드 코덱 기반 클래스 (토픽 필터별로 등록)
+class PayloadCodec {
+public:
+    virtual ~PayloadCodec() = default;
+    virtual const char* name() const = 0;
+};
+
+// View 타입으로 디코딩하는 코덱
+// View 는 payload 버퍼를 복사하지 않고 가리키는 타입이어야 한다
+// (예: flatbuffers::GetRoot<T>() 포인터, capnp::FlatArrayMessageReader, simdjson 문서 등)
+template <typename View>
+class TypedCodec : public PayloadCodec {
+public:
+    // 실패 시 nullopt
+    virtual std::optional<View> decode(std::string_view payload) const = 0;
+};
+
+// 함수로 코덱 생성
+// 예: make_codec<const Telemetry*>("flatbuffers", [](std::string_view p) -> std::optional<const Telemetry*> {
+//         flatbuffers::Verifier v(reinterpret_cast<const uint8_t*>(p.data()), p.size());
+//         if (!VerifyTelemetryBuffer(v)) return std::nullopt;
+//         return GetTelemetry(p.data());
+//     });
+template <typename View>
+std::shared_ptr<TypedCodec<View>> make_codec(
+        std::string name, std::function<std::optional<View>(std::string_view)> decode) {
+    class FunctionCodec : public TypedCodec<View> {
+    public:
+        FunctionCodec(std::string name, std::function<std::optional<View>(std::string_view)> fn)
+            : name_(std::move(name)), fn_(std::move(fn)) {}
+        const char* name() const override { return name_.c_str(); }
+        std::optional<View> decode(std::string_view payload) const override { return fn_(payload); }
+    private:
+        std::string name_;  // 호출자의 임시 문자열을 가리키지 않도록 복사
+        std::function<std::optional<View>(std::string_view)> fn_;
+    };
+    return std::make_shared<FunctionCodec>(std::move(name), std::move(decode));
+}
+
+// 토픽 필터 → 코덱 레지스트리
+// 수신 이벤트의 payload 위에 타입 뷰를 만들고, 필터별 디코딩 비용을 집계한다
+// 디코딩은 이벤트를 꺼낸 소비자 스레드에서 수행되므로 MQTT 콜백 경로에 비용이 없다
+class CodecRegistry {
+public:
+    struct CodecStats {
+        std::string topic_filter;
+        std::string codec;
+        uint64_t decoded = 0;
+        uint64_t failures = 0;
+        std::chrono::nanoseconds total_time{0};
+        std::chrono::nanoseconds max_time{0};
+    };
+
+    CodecRegistry() = default;
+    CodecRegistry(const CodecRegistry&) = delete;
+    CodecRegistry& operator=(const CodecRegistry&) = delete;
+
+    // 먼저 등록된 필터가 우선
+    void register_codec(const std::string& topic_filter, std::shared_ptr<PayloadCodec> codec) {
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto entry = std::make_unique<Entry>();
+        entry->topic_filter = topic_filter;
+        entry->codec = std::move(codec);
+        entries_.push_back(std::move(entry));
+    }
+
+    // 이벤트 payload 위의 뷰 - 이벤트가 살아 있는 동안만 유효
+    template <typename View>
+    std::optional<View> decode(const MQTTEvent& event) {
+        return decode<View>(event.topic, event.payload);
+    }
+
+    // 코덱이 없거나, 등록된 코덱의 View 타입이 다르거나, 디코딩에 실패하면 nullopt
+    template <typename View>
+    std::optional<View> decode(std::string_view topic, std::string_view payload) {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        Entry* entry = find(topic);
+        if (!entry) {
+            return std::nullopt;
+        }
+        auto* codec = dynamic_cast<const TypedCodec<View>*>(entry->codec.get());
+        if (!codec) {
+            return std::nullopt;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::optional<View> view = codec->decode(payload);
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+
+        entry->total_ns.fetch_add(elapsed, std::memory_order_relaxed);
+        int64_t max = entry->max_ns.load(std::memory_order_relaxed);
+        while (elapsed > max && !entry->max_ns.compare_exchange_weak(max, elapsed, std::memory_order_relaxed)) {
+        }
+        if (view.has_value()) {
+            entry->decoded.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            entry->failures.fetch_add(1, std::memory_order_relaxed);
+        }
+        return view;
+    }
+
+    bool has_codec(std::string_view topic) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        return find(topic) != nullptr;
+    }
+
+    // 필터별 디코딩 통계 스냅샷
+    std::vector<CodecStats> stats() const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<CodecStats> result;
+        for (const auto& entry : entries_) {
+            CodecStats s;
+            s.topic_filter = entry->topic_filter;
+            s.codec = entry->codec->name();
+            s.decoded = entry->decoded.load(std::memory_order_relaxed);
+            s.failures = entry->failures.load(std::memory_order_relaxed);
+            s.total_time = std::chrono::nanoseconds(entry->total_ns.load(std::memory_order_relaxed));
+            s.max_time = std::chrono::nanoseconds(entry->max_ns.load(std::memory_order_relaxed));
+            result.push_back(std::move(s));
+        }
+        return result;
+    }
+
+private:
+    struct Entry {
+        std::string topic_filter;
+        std::shared_ptr<PayloadCodec> codec;
+        std::atomic<uint64_t> decoded{0};
+        std::atomic<uint64_t> failures{0};
+        std::atomic<int64_t> total_ns{0};
+        std::atomic<int64_t> max_ns{0};
+    };
+
+    Entry* find(std::string_view topic) const {
+        for (const auto& entry : entries_) {
+            if (topic_matches(entry->topic_filter, topic)) {
+                return entry.get();
+            }
+        }
+        return nullptr;
+    }
+
+    mutable std::shared_mutex mutex_;
+    std::vector<std::unique_ptr<Entry>> entries_;
+};
+
+} // namespace mqtt_client
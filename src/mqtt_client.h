@@ -1,27 +1,50 @@
 #pragma once
 
 #include "event_queue.h"
+#include "credential_provider.h"
+#include "dedup_filter.h"
+#include "sequencer.h"
+#include "retained_cache.h"
+#include "last_value_cache.h"
+#include "delivery_policy.h"
+#include "connect_scheduler.h"
+#include "flight_recorder.h"
+#include "topic_stats.h"
+#include "alloc_tracking.h"
+#include "feature_config.h"
+#include "client_export.h"
 #include <MQTTAsync.h>
 #include <string>
 #include <memory>
 #include <atomic>
 #include <thread>
 #include <optional>
-#include <filesystem>
 #include <chrono>
 #include <queue>
+#include <deque>
+#include <vector>
+#include <map>
+#include <functional>
+#include <string_view>
+#include <mutex>
+#include <shared_mutex>
 
 #ifdef _WIN32
+    #include <winsock2.h>  // windows.h 보다 먼저 (프록시 주소 해석)
+    #include <ws2tcpip.h>
     #include <windows.h>
-    #include <wincrypt.h>
-    #pragma comment(lib, "crypt32.lib")
-    #pragma comment(lib, "paho-mqtt3as.lib")
-#elif __APPLE__
+    #if MQTT_FEATURE_TLS
+        #include <wincrypt.h>
+        #pragma comment(lib, "crypt32.lib")
+        #pragma comment(lib, "paho-mqtt3as.lib")
+    #else
+        #pragma comment(lib, "paho-mqtt3a.lib")
+    #endif
+#elif __APPLE__ && MQTT_FEATURE_TLS
     #include <Security/Security.h>
     #include <CoreFoundation/CoreFoundation.h>
 #endif
 
-namespace fs = std::filesystem;
 namespace mqtt_client {
 
 struct MQTTConfig {
@@ -30,6 +53,9 @@ struct MQTTConfig {
     std::string client_id;
     std::optional<std::string> username;
     std::optional<std::string> password;
+    // 자격 증명 공급자 (선택사항) - 설정 시 username/password 대신 사용
+    // 캐시된 토큰으로 연결하며, 자동 재연결 시마다 최신 토큰을 다시 적용한다
+    std::shared_ptr<CredentialProvider> credential_provider;
     std::string websocket_path = "/mqtt";
     int keep_alive_seconds = 20;
     int qos = 1;
@@ -37,12 +63,39 @@ struct MQTTConfig {
     int max_retry_interval = 60;
     std::optional<std::string> cert_file_path;  // 인증서 파일 경로 (선택사항)
 
+    // 클라이언트 인증서 (mTLS, 선택사항) - 파일 경로 또는 메모리 내 PEM/DER 데이터
+    // 최초 연결 시 한 번 파싱/검증되어 재연결 간에 캐시된다
+    std::optional<std::string> client_cert_file;
+    std::optional<std::string> client_key_file;
+    std::optional<std::string> client_cert_data;
+    std::optional<std::string> client_key_data;
+    std::optional<std::string> client_key_password;  // 암호화된 개인키용
+
     // 프로토콜 설정 (수정됨)
-    bool use_websockets = true;    // true: WebSocket, false: TCP
-    bool use_ssl = true;           // true: 보안(WSS/MQTTS), false: 비보안(WS/MQTT)
+    bool use_websockets = features::websockets;  // true: WebSocket, false: TCP
+    bool use_ssl = features::tls;                // true: 보안(WSS/MQTTS), false: 비보안(WS/MQTT)
     
+    // WebSocket 전송 설정 (use_websockets 일 때만 적용)
+    // Paho 는 MQTT 패킷 하나를 WebSocket 프레임 하나로 보내므로 프레임 크기 = 패킷 크기
+    std::map<std::string, std::string> websocket_headers;  // 핸드셰이크 추가 헤더
+    size_t websocket_max_frame_size = 0;     // 발행 프레임 최대 크기 (0 = 제한 없음), 초과 시 PUBLISH_FAILURE
+
+    // HTTP 프록시 (선택사항, HTTP CONNECT 터널) - "http://[user:pass@]host:port"
+    // http_proxy 는 ws/tcp, https_proxy 는 wss/ssl 연결에 사용된다
+    // 프록시 주소는 한 번 해석되어 프로세스 전역에 캐시된다 (proxy_resolve_ttl_seconds)
+    std::optional<std::string> http_proxy;
+    std::optional<std::string> https_proxy;
+    std::optional<std::string> proxy_username;  // URL 에 넣지 않고 별도로 지정할 때
+    std::optional<std::string> proxy_password;
+    int proxy_resolve_ttl_seconds = 300;
+
     int connection_check_interval_ms = 1000; // 연결 체크 간격
+    int migration_drain_timeout_ms = 5000;   // 연결 전환 시 이전 연결의 전송 완료 대기 최대 시간
     
+    bool has_client_certificate() const {
+        return client_cert_file.has_value() || client_cert_data.has_value();
+    }
+
     // 프로토콜 문자열 반환 헬퍼
     std::string get_protocol_string() const {
         if (use_websockets) {
@@ -60,18 +113,96 @@ struct MQTTConfig {
             return use_ssl ? 8883 : 1883;  // MQTTS : MQTT
         }
     }
+
+    // 연결(MQTTAsync_create/connect)에 반영되는 설정이 같은지 비교
+    // 다르면 설정 변경 시 재연결이 필요하다
+    bool same_connection_settings(const MQTTConfig& other) const {
+        return broker_host == other.broker_host &&
+               broker_port == other.broker_port &&
+               client_id == other.client_id &&
+               username == other.username &&
+               password == other.password &&
+               credential_provider == other.credential_provider &&
+               websocket_path == other.websocket_path &&
+               keep_alive_seconds == other.keep_alive_seconds &&
+               min_retry_interval == other.min_retry_interval &&
+               max_retry_interval == other.max_retry_interval &&
+               cert_file_path == other.cert_file_path &&
+               client_cert_file == other.client_cert_file &&
+               client_key_file == other.client_key_file &&
+               client_cert_data == other.client_cert_data &&
+               client_key_data == other.client_key_data &&
+               client_key_password == other.client_key_password &&
+               use_websockets == other.use_websockets &&
+               websocket_headers == other.websocket_headers &&
+               http_proxy == other.http_proxy &&
+               https_proxy == other.https_proxy &&
+               proxy_username == other.proxy_username &&
+               proxy_password == other.proxy_password &&
+               use_ssl == other.use_ssl;
+    }
 };
 
-class MQTTClient {
+// 클라이언트 통계 (get_stats() 스냅샷)
+struct ClientStats {
+    uint64_t connect_count = 0;                       // 성공한 연결 수 (전환 포함)
+    std::chrono::milliseconds last_connect_time{0};   // connect 요청 → CONNACK (TCP/TLS/WS 핸드셰이크 포함)
+    bool last_connect_via_proxy = false;
+    // 전송량 - MQTT PUBLISH 패킷 + WebSocket 프레임 헤더 기준 추정치 (TLS 레코드 제외)
+    uint64_t messages_sent = 0;
+    uint64_t bytes_sent = 0;
+    uint64_t messages_received = 0;
+    uint64_t bytes_received = 0;
+    uint64_t frames_rejected = 0;                     // websocket_max_frame_size 초과로 거부된 발행
+    uint64_t duplicates_dropped = 0;                  // 중복 제거 필터가 버린 재전송
+    uint64_t messages_filtered = 0;                   // 전달 정책/내용 조건으로 버려진 메시지
+    uint64_t messages_conflated = 0;                  // latest-only 정책으로 교체된 메시지
+    std::chrono::milliseconds connect_wait{0};        // 최근 연결의 스케줄러 대기 시간
+    AllocationStats allocations{};                    // 지점별 할당 (MQTT_ENABLE_ALLOC_TRACKING 빌드, 프로세스 전체)
+};
+
+// 수신 메시지 가로채기 훅 - Paho 콜백 스레드에서 MQTTEvent 생성 전에 호출됨
+// true 를 반환하면 메시지를 소비한 것으로 보고 EventQueue 로 전달하지 않는다
+using MessageInterceptor = std::function<bool(std::string_view topic, std::string_view payload, int qos)>;
+// 새 세션 연결 알림 (최초 연결, 세션을 잃은 재연결) - 재구독 등에 사용
+// 구독을 복원한 뒤 넘어가는 연결 전환(make-before-break)에서는 호출하지 않는다
+using ConnectListener = std::function<void()>;
+// 훅 해제용 핸들
+using HookId = uint64_t;
+
+// 클라이언트 정책 - 이벤트 전달 대상, 작업 큐, 할당자를 컴파일 시점에 선택 (가상 호출 없음)
+//   EventSink           : push(MQTTEvent), push_latest(MQTTEvent), conflated() 제공
+//                         (Paho 콜백 스레드와 MQTT 스레드에서 동시에 호출된다)
+//   WorkQueue<T, Alloc> : std::queue 와 같은 push / front / pop / empty / size / swap, 복사 가능
+//                         (work_mutex_ 아래에서만 접근하므로 자체 동기화는 필요 없다)
+//   Allocator<T>        : 작업 큐와 전송 중 발행 테이블의 할당자
+// 다른 정책으로 인스턴스화하려면 한 번역 단위에서 mqtt_client_impl.h 를 포함하고
+// template class BasicMQTTClient<MyPolicy>; 를 선언한다
+struct DefaultClientPolicy {
+    using EventSink = EventQueue;
+    template <class T>
+    using Allocator = std::allocator<T>;
+    template <class T, class Alloc>
+    using WorkQueue = std::queue<T, std::deque<T, Alloc>>;
+};
+
+template <class Policy = DefaultClientPolicy>
+class BasicMQTTClient {
 public:
-    explicit MQTTClient(const MQTTConfig& config, EventQueue& event_queue);
-    ~MQTTClient();
+    using EventSink = typename Policy::EventSink;
+
+    explicit BasicMQTTClient(const MQTTConfig& config, EventSink& event_queue);
+    ~BasicMQTTClient();
 
-    MQTTClient(const MQTTClient&) = delete;
-    MQTTClient& operator=(const MQTTClient&) = delete;
+    BasicMQTTClient(const BasicMQTTClient&) = delete;
+    BasicMQTTClient& operator=(const BasicMQTTClient&) = delete;
 
     // Thread에서 실행될 메인 함수
     void run();
+
+    // 메인 루프 한 번 실행 (블로킹 없음) - ClientHost 등 외부 스레드 풀에서 구동할 때 사용
+    // 종료(중지 요청 처리 완료 또는 연결 실패)되면 false. run() 과 함께 사용하지 않는다
+    bool poll_once();
     
     // Thread 중지 요청
     void stop();
@@ -81,15 +212,113 @@ public:
     
     // MQTT 작업 요청 (Thread-safe)
     void request_subscribe(const std::string& topic, int qos = 1);
+    // 전달 정책 지정 구독 (N 번째마다 / 간격당 1개 / 최신 값만 / 페이로드 조건)
+    // 수신 즉시 이벤트 생성 전에 적용
+    void request_subscribe(const std::string& topic, int qos, const DeliveryPolicy& policy);
     void request_publish(const std::string& topic, const std::string& payload, 
                         int qos = 1, bool retained = false);
     void request_unsubscribe(const std::string& topic);
 
+    // 설정 변경 요청 (Thread-safe) - MQTT 스레드에서 적용됨
+    // 연결 관련 설정이 바뀌면 새 연결을 먼저 맺은 뒤 기존 연결을 닫는다 (make-before-break)
+    // 그 외 설정(qos, connection_check_interval_ms)은 즉시 적용되며, 작업 큐는 유지된다
+    void update_config(const MQTTConfig& config);
+
+    // 다른 브로커 노드로 무중단 이전 요청 (Thread-safe)
+    // 새 연결에 구독을 복원한 뒤 발행을 전환하고, 이전 연결은 전송 완료 후 닫는다
+    // 같은 host/port 로도 새 연결을 맺는다 (로드밸런서 뒤 재분산용)
+    void migrate_to(const std::string& host, int port);
+
+#if MQTT_FEATURE_HEALTH_CHECK
     void check_connection_health();
+#else
+    void check_connection_health() {}
+#endif
+
+    // 훅 등록/해제 (Thread-safe) - 해제가 반환되면 그 훅은 더 이상 실행 중이 아니다
+    // 훅 안에서 훅을 등록/해제하면 교착된다
+    HookId add_message_interceptor(MessageInterceptor interceptor);
+    HookId add_connect_listener(ConnectListener listener);
+    void remove_message_interceptor(HookId id);
+    void remove_connect_listener(HookId id);
+    // QoS 1 재전송 중복 제거 - 중복은 이벤트 생성/큐잉 전에 버려진다
+    void set_dedup_filter(std::shared_ptr<DedupFilter> filter) { dedup_filter_ = std::move(filter); }
+    // 토픽별 순서 보장 - 순서대로 큐잉하고 누락 시 SEQUENCE_GAP 이벤트 발생
+    void set_sequencer(std::shared_ptr<Sequencer> sequencer) { sequencer_ = std::move(sequencer); }
+    // retained 스냅샷 캐시 - run() 시작 시 캐시 값을 from_snapshot 이벤트로 먼저 전달하고,
+    // 이후 수신한 retained 메시지로 갱신한다 (캐시와 같은 값의 재전송은 이벤트를 만들지 않음)
+    void set_retained_cache(std::shared_ptr<RetainedCache> cache) { retained_cache_ = std::move(cache); }
+    // 토픽별 마지막 값 캐시 - 수신 시 갱신되며 다른 스레드에서 잠금 없이 조회
+    // (Sequencer 가 있으면 순서대로 배출된 값으로 갱신 - 늦게 온 지난 번호는 반영되지 않음)
+    void set_last_value_cache(std::shared_ptr<LastValueCache> cache) { last_value_cache_ = std::move(cache); }
+    // 비행 기록기 - 큐에 넣는 모든 이벤트와 전송하는 작업을 기록 (열려있지 않으면 run() 시작 시 연다)
+    void set_flight_recorder(std::shared_ptr<FlightRecorder> recorder) { flight_recorder_ = std::move(recorder); }
+    // 토픽별 상위 K 트래픽 (수신/송신 × 메시지/바이트) - 다른 스레드에서 stats->top() 으로 조회
+    void set_topic_stats(std::shared_ptr<TopicStats> stats) { topic_stats_ = std::move(stats); }
+    // 발행/수신 추적 span (MQTT_ENABLE_TRACING 빌드에서만 동작, 그 외에는 무시)
+    void set_tracer(std::shared_ptr<Tracer> tracer) { tracer_ = std::move(tracer); }
+    // 애플리케이션이 MESSAGE_ARRIVED 이벤트 처리를 마친 뒤 호출 - 수신 span 종료
+    void trace_handled(const MQTTEvent& event) {
+#ifdef MQTT_ENABLE_TRACING
+        if (tracer_ && event.trace.sampled()) {
+            int64_t dequeued = event.trace.dequeued_ns ? event.trace.dequeued_ns : event.trace.mark_ns;
+            tracer_->span(event.trace, "mqtt.receive.queue", event.trace.mark_ns, dequeued, event.topic);
+            tracer_->span(event.trace, "mqtt.receive.handler", dequeued, Tracer::now_ns(), event.topic);
+            tracer_->finish(event.trace, "mqtt.receive", event.topic);
+        }
+#else
+        (void)event;
+#endif
+    }
+
+    // 통계 조회 (Thread-safe)
+    ClientStats get_stats() const;
+
+    // 웜 스타트 스냅샷 (대기 작업 / 구독 레지스트리 / 전송 중 QoS 1·2 발행 / 엔드포인트·신뢰 저장소)
+    // save_snapshot: run() 종료 후 호출 (전송 중 메시지는 다시 발행되므로 최소 1회 전달)
+    // load_snapshot: run() 전에 호출 - 복원한 작업을 기존 대기 작업 앞에 넣는다
+    bool save_snapshot(const std::string& path) const;
+    bool load_snapshot(const std::string& path);
     
     MQTTAsync get_client() const { return client_; }
 
+    // 브로커 없이 수신 경로 실행 - Paho 수신 콜백과 같은 처리 (중복 제거, 전달 정책, 캐시, 이벤트 큐잉)
+    // 벤치마크/테스트용, 호출한 스레드에서 실행된다
+    void inject_message(std::string_view topic, std::string_view payload, int qos = 0, bool retained = false);
+
 private:
+    // Paho 핸들별 콜백 컨텍스트
+    // make-before-break 전환 중에는 활성/대기 연결이 동시에 존재하므로
+    // 콜백이 어느 핸들에서 왔는지 구분하기 위해 사용한다
+    struct Connection {
+        BasicMQTTClient* owner = nullptr;
+        MQTTAsync handle = nullptr;
+        // 이 핸들의 클라이언트 ID - 같은 ID 로 CONNECT 하면 브로커가 기존 연결을 끊으므로
+        // 대기 연결은 활성 연결과 다른 ID 를 쓴다 (standby_client_id)
+        std::string client_id;
+        std::shared_ptr<CredentialProvider> credentials;  // 재연결 시 토큰 갱신용
+        bool websocket = false;
+        // 핸드셰이크 헤더 (Paho 에 전달한 포인터가 핸들 수명 동안 유효하도록 보관)
+        std::vector<std::pair<std::string, std::string>> header_storage;
+        std::vector<MQTTAsync_nameValue> http_headers;
+        std::string proxy_url;  // 해석된 프록시 주소 (비어 있으면 직접 연결)
+        std::atomic<bool> connected{false};
+        std::atomic<bool> failed{false};
+        std::atomic<bool> closed{false};
+        std::chrono::steady_clock::time_point connect_started;
+        std::atomic<bool> connect_timed{false};
+        std::atomic<bool> connect_permit{false};  // ConnectScheduler 허가 보유 (첫 연결 완료 시 반납)
+
+        // 전환 전 구독 복원 상태 (대기 연결)
+        bool restore_started = false;
+        std::atomic<int> pending_subscriptions{0};
+        // 전환 중 끊긴 활성 연결 - 자동 재연결을 멈춤 (전환이 실패하면 현재 설정으로 다시 연결)
+        bool reconnect_stopped = false;
+        // 전환 후 드레인 상태 (이전 연결)
+        bool disconnect_requested = false;
+        std::chrono::steady_clock::time_point drain_deadline;
+    };
+
     // 콜백 함수들 (static)
     static void on_connection_lost(void* context, char* cause);
     static int on_message_arrived(void* context, char* topicName, int topicLen, MQTTAsync_message* message);
@@ -100,37 +329,138 @@ private:
     static void on_subscribe_failure(void* context, MQTTAsync_failureData* response);
     static void on_send_success(void* context, MQTTAsync_successData* response);
     static void on_send_failure(void* context, MQTTAsync_failureData* response);
+    static void on_disconnect_complete(void* context, MQTTAsync_successData* response);
+    static void on_disconnect_failure(void* context, MQTTAsync_failureData* response);
+    static int on_update_connect_options(void* context, MQTTAsync_connectData* data);
 
+#if MQTT_FEATURE_TLS
     // 인증서 관련 (SSL 사용 시에만 플랫폼별 인증서 추출)
     std::string extract_windows_certificates();
     std::string extract_macos_certificates();
     std::string extract_system_certificates();  // 플랫폼 자동 선택
-    std::string setup_ssl_cert();
+    std::string setup_ssl_cert(const MQTTConfig& config);
+    std::string find_system_trust_store(bool& temporary);
+    void release_trust_store();
+
+    // 클라이언트 인증서 (mTLS) - 파싱 결과를 캐시해 재연결 시 재사용
+    struct ClientIdentity {
+        size_t fingerprint = 0;          // 입력 변경 감지용
+        std::string cert_path;           // Paho keyStore
+        std::string key_path;            // Paho privateKey
+        std::optional<std::string> key_password;  // Paho privateKeyPassword
+        std::vector<std::string> temp_files;
+    };
+    const ClientIdentity& setup_client_identity(const MQTTConfig& config);
+    void remove_client_identity_files();
     // Base64 인코딩 헬퍼
     std::string base64_encode(const unsigned char* data, size_t length);
+#endif
  
     // MQTT 연결
     bool connect_to_broker();
     void disconnect_from_broker();
+    bool open_connection(Connection& conn, const MQTTConfig& config, const std::string& client_id);
+    void close_connection(Connection& conn);
+    bool is_active(const Connection* conn) const { return active_conn_.load() == conn; }
+
+    // 프록시 URL 에 캐시된 주소와 인증 정보를 적용
+    static std::string resolve_proxy_url(const MQTTConfig& config);
+
+    // 자격 증명 공급자가 있으면 토큰이 준비되었는지 (블로킹 없음)
+    static bool credentials_ready(const MQTTConfig& config);
+
+    // 설정 변경 / 연결 전환
+    void apply_pending_config();
+    void check_standby_connection();
+    std::string standby_client_id(const std::string& configured) const;
+    void abandon_standby();
+    bool restore_subscriptions(Connection& conn);
+    void reap_closed_connections();
     // 작업 처리
     void process_requests();
 
-    // 활동 추적
+    // 활동 추적 (상태 점검 제외 빌드에서는 빈 함수)
+#if MQTT_FEATURE_HEALTH_CHECK
     void update_last_activity();
-    bool detect_sleep_resume();    
+    bool detect_sleep_resume();
+#else
+    void update_last_activity() {}
+#endif
 
     MQTTConfig config_;
-    EventQueue& event_queue_;
-    MQTTAsync client_;
+    EventSink& event_queue_;
+    MQTTAsync client_;                          // 활성 연결의 핸들
+
+    // 연결 (MQTT 스레드에서만 변경)
+    std::unique_ptr<Connection> conn_;          // 활성 연결
+    std::unique_ptr<Connection> standby_;       // 전환 대기 중인 새 연결
+    std::vector<std::unique_ptr<Connection>> closing_;  // 종료 중인 이전 연결
+    Connection injected_;                        // inject_message() 의 콜백 컨텍스트 (핸들 없음)
+    std::atomic<Connection*> active_conn_{nullptr};     // 콜백에서 활성 여부 판별용
+    MQTTConfig standby_config_;
+
+    // 설정 변경 요청 (config_ 변경도 이 뮤텍스 아래에서 수행)
+    mutable std::mutex config_mutex_;
+    std::optional<MQTTConfig> pending_config_;
+    bool force_reconnect_ = false;
     
     std::atomic<bool> connected_{false};
     std::atomic<bool> should_stop_{false};
     
-    std::string temp_cert_file_;
+#if MQTT_FEATURE_TLS
+    bool trust_store_acquired_ = false;  // 공용 신뢰 저장소 참조 중
+#endif
+
+    // 메인 루프 상태 (poll_once)
+    enum class RunState { IDLE, WAITING_CREDENTIALS, RUNNING, STOPPED };
+    RunState run_state_ = RunState::IDLE;
+#if MQTT_FEATURE_HEALTH_CHECK
+    std::chrono::steady_clock::time_point last_health_check_;
+#endif
+    bool connect_queued_ = false;  // ConnectScheduler 대기 중
+    std::chrono::steady_clock::time_point connect_queued_at_;
+    static void release_connect_permit(Connection& conn, bool success);
+
+    // 훅 - 수신 경로는 공유 잠금으로 조회
+    mutable std::shared_mutex hooks_mutex_;
+    HookId next_hook_id_ = 1;
+    std::vector<std::pair<HookId, MessageInterceptor>> interceptors_;
+    std::vector<std::pair<HookId, ConnectListener>> connect_listeners_;
+    std::shared_ptr<DedupFilter> dedup_filter_;
+    std::shared_ptr<Sequencer> sequencer_;
+    std::shared_ptr<RetainedCache> retained_cache_;
+    std::shared_ptr<LastValueCache> last_value_cache_;
+    DeliveryPolicies delivery_policies_;
+    std::shared_ptr<FlightRecorder> flight_recorder_;
+    std::shared_ptr<Tracer> tracer_;
+    std::shared_ptr<TopicStats> topic_stats_;
+    void notify_connected();
+    // 이벤트 큐잉 (비행 기록기가 있으면 먼저 기록, latest 는 최신 값만 유지)
+    void emit(MQTTEvent&& event, bool latest = false);
+    // Sequencer 가 배출한 이벤트 - 마지막 값 캐시를 배출 순서대로 갱신한 뒤 큐잉
+    void emit_sequenced(MQTTEvent&& event);
+    void update_last_value(std::string_view topic, std::string_view payload, bool retained);
+    void publish_retained_snapshot();
+#if MQTT_FEATURE_TLS
+    std::optional<ClientIdentity> client_identity_;
+#endif
+
+    // 통계
+    std::atomic<uint64_t> connect_count_{0};
+    std::atomic<int64_t> connect_wait_ms_{0};
+    std::atomic<int64_t> last_connect_ms_{0};
+    std::atomic<bool> last_connect_via_proxy_{false};
+    std::atomic<uint64_t> messages_sent_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> messages_received_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+    std::atomic<uint64_t> frames_rejected_{0};
     
+#if MQTT_FEATURE_HEALTH_CHECK
     std::chrono::steady_clock::time_point last_activity_;
     std::chrono::steady_clock::time_point last_check_time_;
     mutable std::mutex activity_mutex_;
+#endif
 
     // 작업 큐
     struct WorkItem {
@@ -140,10 +470,44 @@ private:
         std::string payload;
         int qos;
         bool retained;
+#ifdef MQTT_ENABLE_TRACING
+        TraceContext trace;
+#endif
     };
     
+    template <class T>
+    using Allocator = typename Policy::template Allocator<T>;
+    using WorkQueue = typename Policy::template WorkQueue<WorkItem, Allocator<WorkItem>>;
+    using InFlightKey = std::pair<const Connection*, MQTTAsync_token>;
+
     mutable std::mutex work_mutex_;
-    std::queue<WorkItem> work_queue_;
+    WorkQueue work_queue_;
+    std::map<std::string, int> subscriptions_;  // 구독 레지스트리 (topic -> qos), work_mutex_ 보호
+
+    // 전송 중인 QoS 1·2 발행 (핸들별 토큰 -> 발행 순번, 작업), 완료/실패 콜백에서 제거
+    // 연결 끊김/종료로 실패하면 resend_ 로 옮겨 다음 연결에서 발행 순서대로 다시 보낸다 (스냅샷에도 포함)
+    struct InFlight {
+        uint64_t sequence;
+        WorkItem item;
+    };
+    mutable std::mutex in_flight_mutex_;
+    uint64_t next_publish_sequence_ = 0;
+    std::map<InFlightKey, InFlight, std::less<InFlightKey>, Allocator<std::pair<const InFlightKey, InFlight>>> in_flight_;
+    std::map<uint64_t, WorkItem, std::less<uint64_t>, Allocator<std::pair<const uint64_t, WorkItem>>> resend_;
+    // 다시 보내도록 옮겼으면 true
+    bool complete_in_flight(const Connection* conn, MQTTAsync_token token, bool success, bool connection_lost = false);
+    // 닫는 연결의 남은 항목 정리 - 발행은 resend_ 로 옮기고 추적 span 은 실패로 종료
+    // (해제된 Connection 주소가 재사용되면 새 연결의 토큰과 섞이므로 핸들 해제 전에 호출)
+    void purge_in_flight(const Connection* conn);
+#ifdef MQTT_ENABLE_TRACING
+    // 샘플링된 발행의 응답 대기 (토픽, 추적 문맥) - in_flight_mutex_ 보호, QoS 0 포함
+    std::map<InFlightKey, std::pair<std::string, TraceContext>> traced_sends_;
+#endif
 };
 
+using MQTTClient = BasicMQTTClient<DefaultClientPolicy>;
+
+// 기본 정책은 mqtt_client.cpp 에서 한 번만 인스턴스화
+extern template class MQTT_CLIENT_API BasicMQTTClient<DefaultClientPolicy>;
+
 } // namespace mqtt_client
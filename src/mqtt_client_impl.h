@@ -0,0 +1,2304 @@
+#pragma once
+
+// BasicMQTTClient 템플릿 정의 - 기본 정책(MQTTClient)은 mqtt_client.cpp 에서 인스턴스화된다
+// 사용자 정책으로 인스턴스화할 때만 한 번역 단위에서 포함한다
+#include "mqtt_client.h"
+#include "log.h"
+#if MQTT_FEATURE_TLS
+    #include <openssl/pem.h>
+    #include <openssl/x509.h>
+    #include <openssl/evp.h>
+    #include <openssl/rand.h>
+#endif
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+    #include <share.h>
+    #include <sys/stat.h>
+    #include <random>
+#else
+    #include <sys/types.h>
+    #include <sys/socket.h>
+    #include <netdb.h>
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+    #include <cerrno>
+    #include <cstdlib>
+#endif
+#include <sstream>
+#include <fstream>
+#if MQTT_FEATURE_TLS
+    #include <filesystem>  // 인증서 경로 / 임시 파일 (스냅샷은 std::rename 만 사용)
+#endif
+#include <cstdio>
+#include <vector>
+#include <cstring>
+#include <cctype>
+#include <algorithm>
+#include <limits>
+
+namespace mqtt_client {
+
+#if MQTT_FEATURE_TLS
+namespace fs = std::filesystem;
+#endif
+
+namespace detail {
+
+#ifndef _WIN32
+inline bool write_all(int fd, const std::string& data) {
+    for (size_t offset = 0; offset < data.size();) {
+        ssize_t n = ::write(fd, data.data() + offset, data.size() - offset);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        offset += static_cast<size_t>(n);
+    }
+    return true;
+}
+#endif
+
+// 소유자만 읽을 수 있는 파일로 저장 (POSIX: 0600, 심볼릭 링크를 따라가지 않음)
+inline bool write_private_file(const std::string& path, const std::string& data) {
+#ifdef _WIN32
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    return file && file.write(data.data(), static_cast<std::streamsize>(data.size()));
+#else
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = ::fchmod(fd, 0600) == 0 && write_all(fd, data);  // 이전에 남은 파일의 권한도 좁힘
+    return ::close(fd) == 0 && ok;
+#endif
+}
+
+// from 으로 to 를 교체 (POSIX rename 은 원자적, Windows 는 기존 파일을 덮어쓰도록 MoveFileEx 사용)
+inline bool replace_file(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    return MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(from.c_str(), to.c_str()) == 0;
+#endif
+}
+
+inline bool file_exists(const std::string& path) {
+    struct stat info;
+    return ::stat(path.c_str(), &info) == 0;
+}
+
+} // namespace detail
+
+template <class Policy>
+BasicMQTTClient<Policy>::BasicMQTTClient(const MQTTConfig& config, EventSink& event_queue)
+    : config_(config), event_queue_(event_queue), client_(nullptr) {
+    
+    if (config_.client_id.empty()) {
+        config_.client_id = "mqtt_client_" + 
+            std::to_string(std::chrono::system_clock::now().time_since_epoch().count());
+    }
+
+#if MQTT_FEATURE_HEALTH_CHECK
+    // 활동 시간 초기화
+    last_activity_ = std::chrono::steady_clock::now();
+    last_check_time_ = std::chrono::steady_clock::now();
+#endif
+}
+
+template <class Policy>
+BasicMQTTClient<Policy>::~BasicMQTTClient() {
+    stop();
+}
+
+#if MQTT_FEATURE_TLS
+// ============================================================================
+// 인증서 관련 함수
+// ============================================================================
+// Windows 인증서 추출
+template <class Policy>
+std::string BasicMQTTClient<Policy>::extract_windows_certificates() {
+#ifdef _WIN32
+    std::ostringstream pem_stream;
+    const char* store_names[] = {"ROOT", "CA"};
+    
+    for (const auto& store_name : store_names) {
+        HCERTSTORE hStore = CertOpenSystemStoreA(0, store_name);
+        if (!hStore) {
+            MQTT_LOG_ERROR("[SSL] Failed to open certificate store: " << store_name);
+            continue;
+        }
+
+        PCCERT_CONTEXT pContext = nullptr;
+        while ((pContext = CertEnumCertificatesInStore(hStore, pContext)) != nullptr) {
+            DWORD pem_size = 0;
+            if (CryptBinaryToStringA(pContext->pbCertEncoded, pContext->cbCertEncoded,
+                                     CRYPT_STRING_BASE64HEADER, nullptr, &pem_size)) {
+                std::vector<char> pem_buffer(pem_size);
+                if (CryptBinaryToStringA(pContext->pbCertEncoded, pContext->cbCertEncoded,
+                                         CRYPT_STRING_BASE64HEADER, pem_buffer.data(), &pem_size)) {
+                    pem_stream << pem_buffer.data();
+                }
+            }
+        }
+        CertCloseStore(hStore, 0);
+    }
+    return pem_stream.str();
+#else
+    return "";
+#endif
+}
+
+// macOS 인증서 추출
+template <class Policy>
+std::string BasicMQTTClient<Policy>::extract_macos_certificates() {
+#ifdef __APPLE__
+    std::ostringstream pem_stream;
+    
+    // macOS 10.10+ 에서는 SecTrustCopyAnchorCertificates 사용
+    CFArrayRef anchor_certs = nullptr;
+    OSStatus status = SecTrustCopyAnchorCertificates(&anchor_certs);
+    
+    if (status == errSecSuccess && anchor_certs) {
+        CFIndex count = CFArrayGetCount(anchor_certs);
+        MQTT_LOG("[SSL] Found " << count << " anchor certificates");
+        
+        for (CFIndex i = 0; i < count; i++) {
+            SecCertificateRef cert = (SecCertificateRef)CFArrayGetValueAtIndex(anchor_certs, i);
+            
+            // 인증서를 DER 형식으로 추출
+            CFDataRef cert_data = SecCertificateCopyData(cert);
+            if (cert_data) {
+                const UInt8* der_data = CFDataGetBytePtr(cert_data);
+                CFIndex der_length = CFDataGetLength(cert_data);
+                
+                // DER을 PEM으로 변환
+                pem_stream << "-----BEGIN CERTIFICATE-----\n";
+                
+                std::string base64 = base64_encode(der_data, der_length);
+                for (size_t j = 0; j < base64.length(); j += 64) {
+                    pem_stream << base64.substr(j, 64) << "\n";
+                }
+                
+                pem_stream << "-----END CERTIFICATE-----\n";
+                
+                CFRelease(cert_data);
+            }
+        }
+        
+        CFRelease(anchor_certs);
+    } else {
+        MQTT_LOG_ERROR("[SSL] Failed to get anchor certificates: " << status);
+    }
+    
+    return pem_stream.str();
+#else
+    return "";
+#endif
+}
+
+// 플랫폼 자동 선택
+template <class Policy>
+std::string BasicMQTTClient<Policy>::extract_system_certificates() {
+#ifdef _WIN32
+    MQTT_LOG("[SSL] Extracting Windows system certificates...");
+    return extract_windows_certificates();
+#elif __APPLE__
+    MQTT_LOG("[SSL] Extracting macOS system certificates...");
+    return extract_macos_certificates();
+#elif __linux__
+    MQTT_LOG("[SSL] Linux detected - using system cert paths");
+    return "";  // Linux는 /etc/ssl/certs 직접 사용
+#else
+    MQTT_LOG_ERROR("[SSL] Unsupported platform for certificate extraction");
+    return "";
+#endif
+}
+
+namespace detail {
+
+// 프로세스 공용 신뢰 저장소 - 클라이언트마다 시스템 인증서를 찾거나 추출하지 않도록 공유
+struct SharedTrustStore {
+    std::mutex mutex;
+    std::string path;
+    bool temporary = false;  // 추출해서 만든 임시 파일 (마지막 사용자가 삭제)
+    int users = 0;
+};
+
+inline SharedTrustStore& shared_trust_store() {
+    static SharedTrustStore store;
+    return store;
+}
+
+// write_private_temp_file 로 만든 파일 삭제 (POSIX 는 전용 디렉터리도 함께)
+inline void remove_private_temp_file(const std::string& path) {
+    std::error_code ec;
+    fs::remove(path, ec);
+#ifndef _WIN32
+    fs::remove(fs::path(path).parent_path(), ec);
+#endif
+}
+
+// 소유자만 읽을 수 있는 임시 파일 생성
+// POSIX: mkdtemp 로 만든 0700 디렉터리 안에 O_EXCL|O_NOFOLLOW, 0600 으로 생성 (경로 예측/심볼릭 링크 공격 방지)
+// Windows: 사용자별 임시 디렉터리에 임의 이름으로 단독 생성
+inline std::string write_private_temp_file(const std::string& name, const std::string& contents) {
+#ifdef _WIN32
+    std::random_device random;
+    fs::path path = fs::temp_directory_path() /
+                    (std::to_string(random()) + std::to_string(random()) + "_" + name);
+    int fd = -1;
+    if (_sopen_s(&fd, path.string().c_str(), _O_WRONLY | _O_CREAT | _O_EXCL | _O_BINARY,
+                 _SH_DENYRW, _S_IREAD | _S_IWRITE) != 0) {
+        throw std::runtime_error("Failed to create temporary file: " + path.string());
+    }
+    bool written = _write(fd, contents.data(), static_cast<unsigned int>(contents.size())) ==
+                   static_cast<int>(contents.size());
+    _close(fd);
+#else
+    std::string dir = (fs::temp_directory_path() / "mqtt_client_XXXXXX").string();
+    if (!mkdtemp(dir.data())) {
+        throw std::runtime_error("Failed to create temporary directory: " + dir);
+    }
+    fs::path path = fs::path(dir) / name;
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_NOFOLLOW | O_CLOEXEC, 0600);
+    if (fd < 0) {
+        ::rmdir(dir.c_str());
+        throw std::runtime_error("Failed to create temporary file: " + path.string());
+    }
+    bool written = write_all(fd, contents);
+    ::close(fd);
+#endif
+    if (!written) {
+        remove_private_temp_file(path.string());
+        throw std::runtime_error("Failed to write temporary file: " + path.string());
+    }
+    return path.string();
+}
+
+} // namespace detail
+
+template <class Policy>
+std::string BasicMQTTClient<Policy>::setup_ssl_cert(const MQTTConfig& config) {
+    // 1. 사용자 지정 인증서 파일
+    if (config.cert_file_path.has_value() && fs::exists(config.cert_file_path.value())) {
+        MQTT_LOG("[SSL] Using provided certificate file: " << config.cert_file_path.value());
+        return config.cert_file_path.value();
+    }
+
+    // 2. 시스템 신뢰 저장소 (프로세스 공용)
+    auto& store = detail::shared_trust_store();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    if (store.path.empty()) {
+        bool temporary = false;
+        store.path = find_system_trust_store(temporary);
+        store.temporary = temporary;
+    }
+    if (!trust_store_acquired_) {
+        ++store.users;
+        trust_store_acquired_ = true;
+    }
+    return store.path;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::release_trust_store() {
+    if (!trust_store_acquired_) {
+        return;
+    }
+    trust_store_acquired_ = false;
+
+    auto& store = detail::shared_trust_store();
+    std::lock_guard<std::mutex> lock(store.mutex);
+    if (--store.users > 0 || !store.temporary) {
+        return;
+    }
+    // 임시 인증서 파일 삭제
+    detail::remove_private_temp_file(store.path);
+    MQTT_LOG("[SSL] Temporary certificate file removed");
+    store.path.clear();
+    store.temporary = false;
+}
+
+template <class Policy>
+std::string BasicMQTTClient<Policy>::find_system_trust_store(bool& temporary) {
+    temporary = false;
+
+    // macOS - OpenSSL 설치 경로 확인
+#ifdef __APPLE__
+    std::vector<std::string> macos_cert_paths = {
+        "/etc/ssl/cert.pem",                           // macOS 시스템 기본
+        "/usr/local/etc/openssl@3/cert.pem",          // Homebrew OpenSSL 3
+        "/usr/local/etc/openssl@1.1/cert.pem",        // Homebrew OpenSSL 1.1
+        "/opt/homebrew/etc/openssl@3/cert.pem",       // Apple Silicon Homebrew
+        "/opt/homebrew/etc/openssl@1.1/cert.pem",     // Apple Silicon Homebrew
+        "/usr/local/etc/openssl/cert.pem"             // Homebrew 구버전
+    };
+    
+    for (const auto& path : macos_cert_paths) {
+        if (fs::exists(path)) {
+            MQTT_LOG("[SSL] Using macOS certificate bundle: " << path);
+            return path;
+        }
+    }
+    
+    MQTT_LOG("[SSL] No pre-installed certificate bundle found, extracting from system...");
+#endif
+    
+    // Linux - 시스템 경로 사용
+#ifdef __linux__
+    std::vector<std::string> linux_cert_paths = {
+        "/etc/ssl/certs/ca-certificates.crt",  // Debian/Ubuntu
+        "/etc/pki/tls/certs/ca-bundle.crt",    // RedHat/CentOS
+        "/etc/ssl/ca-bundle.pem",               // OpenSUSE
+        "/etc/ssl/cert.pem"                     // Generic
+    };
+    
+    for (const auto& path : linux_cert_paths) {
+        if (fs::exists(path)) {
+            MQTT_LOG("[SSL] Using Linux system certificates: " << path);
+            return path;
+        }
+    }
+#endif
+    
+    // 시스템 인증서 추출 (Windows 또는 macOS에서 경로를 못 찾은 경우)
+    MQTT_LOG("[SSL] Extracting system certificates...");
+    std::string pem_certs = extract_system_certificates();
+    
+    if (pem_certs.empty()) {
+        throw std::runtime_error("Failed to extract system certificates and no cert file provided");
+    }
+    
+    // 임시 파일 저장
+    std::string temp_cert_file = detail::write_private_temp_file("mqtt_certs.pem", pem_certs);
+    
+    MQTT_LOG("[SSL] Temporary certificate file created: " << temp_cert_file);
+    temporary = true;
+    return temp_cert_file;
+}
+
+// Base64 인코딩 (macOS/크로스 플랫폼용)
+template <class Policy>
+std::string BasicMQTTClient<Policy>::base64_encode(const unsigned char* data, size_t length) {
+    static const char base64_chars[] = 
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+        "abcdefghijklmnopqrstuvwxyz"
+        "0123456789+/";
+    
+    std::string ret;
+    int i = 0;
+    unsigned char char_array_3[3];
+    unsigned char char_array_4[4];
+    
+    while (length--) {
+        char_array_3[i++] = *(data++);
+        if (i == 3) {
+            char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
+            char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
+            char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
+            char_array_4[3] = char_array_3[2] & 0x3f;
+            
+            for(i = 0; i < 4; i++)
+                ret += base64_chars[char_array_4[i]];
+            i = 0;
+        }
+    }
+    
+    if (i) {
+        for(int j = i; j < 3; j++)
+            char_array_3[j] = '\0';
+        
+        char_array_4[0] = (char_array_3[0] & 0xfc) >> 2;
+        char_array_4[1] = ((char_array_3[0] & 0x03) << 4) + ((char_array_3[1] & 0xf0) >> 4);
+        char_array_4[2] = ((char_array_3[1] & 0x0f) << 2) + ((char_array_3[2] & 0xc0) >> 6);
+        
+        for (int j = 0; j < i + 1; j++)
+            ret += base64_chars[char_array_4[j]];
+        
+        while(i++ < 3)
+            ret += '=';
+    }
+    
+    return ret;
+}
+
+// ============================================================================
+// 클라이언트 인증서 (mTLS)
+// ============================================================================
+namespace detail {
+
+inline bool is_pem(const std::string& data) {
+    return data.find("-----BEGIN") != std::string::npos;
+}
+
+inline std::string read_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Failed to open file: " + path);
+    }
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// PEM 또는 DER 인증서 파싱
+inline X509* parse_certificate(const std::string& data) {
+    if (is_pem(data)) {
+        BIO* bio = BIO_new_mem_buf(data.data(), static_cast<int>(data.size()));
+        X509* cert = bio ? PEM_read_bio_X509(bio, nullptr, nullptr, nullptr) : nullptr;
+        BIO_free(bio);
+        return cert;
+    }
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    return d2i_X509(nullptr, &p, static_cast<long>(data.size()));
+}
+
+// PEM 또는 DER (PKCS#1/PKCS#8, 암호화 PKCS#8 포함) 개인키 파싱
+inline EVP_PKEY* parse_private_key(const std::string& data, const std::optional<std::string>& password) {
+    void* pass = password.has_value() ? const_cast<char*>(password->c_str()) : nullptr;
+    if (is_pem(data)) {
+        BIO* bio = BIO_new_mem_buf(data.data(), static_cast<int>(data.size()));
+        EVP_PKEY* key = bio ? PEM_read_bio_PrivateKey(bio, nullptr, nullptr, pass) : nullptr;
+        BIO_free(bio);
+        return key;
+    }
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(data.data());
+    EVP_PKEY* key = d2i_AutoPrivateKey(nullptr, &p, static_cast<long>(data.size()));
+    if (!key && pass) {
+        BIO* bio = BIO_new_mem_buf(data.data(), static_cast<int>(data.size()));
+        key = bio ? d2i_PKCS8PrivateKey_bio(bio, nullptr, nullptr, pass) : nullptr;
+        BIO_free(bio);
+    }
+    return key;
+}
+
+// 임시 키 파일 암호화용 비밀번호 (32바이트 난수, 16진수)
+inline std::string random_key_password() {
+    unsigned char bytes[32];
+    if (RAND_bytes(bytes, sizeof(bytes)) != 1) {
+        throw std::runtime_error("Failed to generate key password");
+    }
+    static const char hex[] = "0123456789abcdef";
+    std::string password;
+    for (unsigned char byte : bytes) {
+        password += hex[byte >> 4];
+        password += hex[byte & 0x0f];
+    }
+    return password;
+}
+
+inline std::string bio_to_string(BIO* bio) {
+    char* ptr = nullptr;
+    long len = BIO_get_mem_data(bio, &ptr);
+    return std::string(ptr, static_cast<size_t>(len));
+}
+
+inline size_t identity_fingerprint(const MQTTConfig& config) {
+    std::string source;
+    auto add = [&source](const std::optional<std::string>& value) {
+        source += value.has_value() ? value.value() : std::string();
+        source += '\0';
+    };
+    add(config.client_cert_file);
+    add(config.client_key_file);
+    add(config.client_cert_data);
+    add(config.client_key_data);
+    add(config.client_key_password);
+    // 파일이 교체되면 다시 파싱
+    std::error_code ec;
+    for (const auto& path : {config.client_cert_file, config.client_key_file}) {
+        if (path.has_value()) {
+            source += std::to_string(fs::last_write_time(path.value(), ec).time_since_epoch().count());
+        }
+    }
+    return std::hash<std::string>{}(source);
+}
+
+} // namespace detail
+
+template <class Policy>
+const typename BasicMQTTClient<Policy>::ClientIdentity& BasicMQTTClient<Policy>::setup_client_identity(const MQTTConfig& config) {
+    size_t fingerprint = detail::identity_fingerprint(config);
+    if (client_identity_.has_value() && client_identity_->fingerprint == fingerprint) {
+        return client_identity_.value();  // 캐시 재사용 (파싱/파일 생성 생략)
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::string cert_data = config.client_cert_file.has_value()
+        ? detail::read_file(config.client_cert_file.value()) : config.client_cert_data.value();
+    std::string key_data;
+    if (config.client_key_file.has_value()) {
+        key_data = detail::read_file(config.client_key_file.value());
+    } else if (config.client_key_data.has_value()) {
+        key_data = config.client_key_data.value();
+    } else {
+        key_data = cert_data;  // 키가 인증서 PEM 에 함께 들어있는 경우
+    }
+
+    std::unique_ptr<X509, decltype(&X509_free)> cert(detail::parse_certificate(cert_data), X509_free);
+    if (!cert) {
+        throw std::runtime_error("Failed to parse client certificate");
+    }
+    std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(
+        detail::parse_private_key(key_data, config.client_key_password), EVP_PKEY_free);
+    if (!key) {
+        throw std::runtime_error("Failed to parse client private key");
+    }
+    if (X509_check_private_key(cert.get(), key.get()) != 1) {
+        throw std::runtime_error("Client private key does not match certificate");
+    }
+
+    ClientIdentity identity;
+    identity.fingerprint = fingerprint;
+
+    // PEM 파일은 그대로 사용, 메모리/DER 입력은 PEM 임시 파일로 변환
+    if (config.client_cert_file.has_value() && detail::is_pem(cert_data)) {
+        identity.cert_path = config.client_cert_file.value();
+    } else {
+        std::string pem = cert_data;
+        if (!detail::is_pem(cert_data)) {
+            std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new(BIO_s_mem()), BIO_free);
+            PEM_write_bio_X509(bio.get(), cert.get());
+            pem = detail::bio_to_string(bio.get());
+        }
+        identity.cert_path = detail::write_private_temp_file("client_cert.pem", pem);
+        identity.temp_files.push_back(identity.cert_path);
+    }
+
+    if (config.client_key_file.has_value() && detail::is_pem(key_data)) {
+        identity.key_path = config.client_key_file.value();
+        identity.key_password = config.client_key_password;
+    } else {
+        // 임시 파일의 키는 항상 암호화 (비밀번호가 없으면 프로세스 메모리에만 있는 임의 비밀번호 사용)
+        // Paho 에 privateKeyPassword 로 전달
+        identity.key_password = config.client_key_password.has_value()
+            ? config.client_key_password.value() : detail::random_key_password();
+        std::unique_ptr<BIO, decltype(&BIO_free)> bio(BIO_new(BIO_s_mem()), BIO_free);
+        void* pass = const_cast<char*>(identity.key_password->c_str());
+        if (PEM_write_bio_PrivateKey(bio.get(), key.get(), EVP_aes_256_cbc(), nullptr, 0, nullptr, pass) != 1) {
+            throw std::runtime_error("Failed to encode client private key");
+        }
+        identity.key_path = detail::write_private_temp_file("client_key.pem", detail::bio_to_string(bio.get()));
+        identity.temp_files.push_back(identity.key_path);
+    }
+
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    MQTT_LOG("[SSL] Client certificate loaded (" << elapsed_ms << " ms)");
+
+    remove_client_identity_files();
+    client_identity_ = std::move(identity);
+    return client_identity_.value();
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::remove_client_identity_files() {
+    if (!client_identity_.has_value()) {
+        return;
+    }
+    for (const auto& path : client_identity_->temp_files) {
+        detail::remove_private_temp_file(path);
+    }
+    client_identity_.reset();
+}
+#endif // MQTT_FEATURE_TLS
+
+// ============================================================================
+// 전송량 추정
+// ============================================================================
+namespace detail {
+
+// PUBLISH 패킷 크기 (고정 헤더 + 가변 헤더 + 페이로드)
+inline size_t publish_packet_size(size_t topic_len, size_t payload_len, int qos) {
+    size_t remaining = 2 + topic_len + (qos > 0 ? 2 : 0) + payload_len;
+    size_t length_bytes = remaining < 128 ? 1 : remaining < 16384 ? 2 : remaining < 2097152 ? 3 : 4;
+    return 1 + length_bytes + remaining;
+}
+
+#if MQTT_FEATURE_WEBSOCKETS
+// WebSocket 프레임 헤더 크기 (클라이언트 → 서버 프레임은 4바이트 마스크 포함)
+inline size_t websocket_header_size(size_t frame_payload_len, bool masked) {
+    size_t header = frame_payload_len <= 125 ? 2 : frame_payload_len <= 65535 ? 4 : 10;
+    return header + (masked ? 4 : 0);
+}
+#endif
+
+} // namespace detail
+
+// ============================================================================
+// HTTP 프록시
+// ============================================================================
+namespace detail {
+
+// 프록시 호스트 → 숫자 주소 캐시 (프로세스 전역, 재연결/다중 클라이언트 간 공유)
+struct ProxyAddressCache {
+    std::mutex mutex;
+    std::map<std::string, std::pair<std::string, std::chrono::steady_clock::time_point>> entries;
+};
+
+inline ProxyAddressCache& proxy_address_cache() {
+    static ProxyAddressCache cache;
+    return cache;
+}
+
+inline std::string resolve_host_cached(const std::string& host, int ttl_seconds) {
+    auto& cache = proxy_address_cache();
+    auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(cache.mutex);
+        auto it = cache.entries.find(host);
+        if (it != cache.entries.end() && now < it->second.second) {
+            return it->second.first;
+        }
+    }
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        MQTT_LOG_ERROR("[Proxy] Failed to resolve proxy host: " << host);
+        return host;  // Paho 가 직접 해석하도록 그대로 사용
+    }
+    char address[INET6_ADDRSTRLEN] = {0};
+    bool ipv6 = result->ai_family == AF_INET6;
+    getnameinfo(result->ai_addr, static_cast<socklen_t>(result->ai_addrlen),
+                address, sizeof(address), nullptr, 0, NI_NUMERICHOST);
+    freeaddrinfo(result);
+
+    std::string resolved = ipv6 ? "[" + std::string(address) + "]" : std::string(address);
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    cache.entries[host] = {resolved, now + std::chrono::seconds(ttl_seconds)};
+    MQTT_LOG("[Proxy] Resolved " << host << " -> " << resolved);
+    return resolved;
+}
+
+// URL userinfo 용 퍼센트 인코딩
+inline std::string percent_encode(const std::string& value) {
+    static const char hex[] = "0123456789ABCDEF";
+    std::string out;
+    for (unsigned char c : value) {
+        if (std::isalnum(c) || c == '-' || c == '.' || c == '_' || c == '~') {
+            out += static_cast<char>(c);
+        } else {
+            out += '%';
+            out += hex[c >> 4];
+            out += hex[c & 0x0f];
+        }
+    }
+    return out;
+}
+
+} // namespace detail
+
+template <class Policy>
+std::string BasicMQTTClient<Policy>::resolve_proxy_url(const MQTTConfig& config) {
+    const auto& proxy = config.use_ssl ? config.https_proxy : config.http_proxy;
+    if (!proxy.has_value() || proxy->empty()) {
+        return "";
+    }
+
+    // scheme://[userinfo@]host[:port][/...]
+    std::string url = proxy.value();
+    std::string scheme = "http://";
+    size_t pos = url.find("://");
+    if (pos != std::string::npos) {
+        scheme = url.substr(0, pos + 3);
+        url = url.substr(pos + 3);
+    }
+    std::string userinfo;
+    size_t at = url.rfind('@');
+    if (at != std::string::npos) {
+        userinfo = url.substr(0, at + 1);
+        url = url.substr(at + 1);
+    }
+    if (config.proxy_username.has_value()) {
+        userinfo = detail::percent_encode(config.proxy_username.value());
+        if (config.proxy_password.has_value()) {
+            userinfo += ":" + detail::percent_encode(config.proxy_password.value());
+        }
+        userinfo += "@";
+    }
+
+    std::string host = url;
+    std::string rest;
+    if (!url.empty() && url[0] == '[') {          // IPv6 리터럴
+        size_t end = url.find(']');
+        host = url.substr(0, end + 1);
+        rest = end == std::string::npos ? "" : url.substr(end + 1);
+    } else {
+        size_t end = url.find_first_of(":/");
+        if (end != std::string::npos) {
+            host = url.substr(0, end);
+            rest = url.substr(end);
+        }
+    }
+    if (!host.empty() && host[0] != '[') {
+        host = detail::resolve_host_cached(host, config.proxy_resolve_ttl_seconds);
+    }
+    return scheme + userinfo + host + rest;
+}
+
+#if MQTT_FEATURE_HEALTH_CHECK
+// ============================================================================
+// 활동 추적
+// ============================================================================
+template <class Policy>
+void BasicMQTTClient<Policy>::update_last_activity() {
+    std::lock_guard<std::mutex> lock(activity_mutex_);
+    last_activity_ = std::chrono::steady_clock::now();
+}
+
+template <class Policy>
+bool BasicMQTTClient<Policy>::detect_sleep_resume() {
+    std::lock_guard<std::mutex> lock(activity_mutex_);
+    
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(
+        now - last_check_time_).count();
+    
+    // 체크 간격보다 훨씬 오래 걸렸으면 sleep으로 판단
+    // 예: 1초 간격인데 5초 이상 걸렸으면 비정상
+    int expected_interval_sec = config_.connection_check_interval_ms / 1000 + 1;
+    if (elapsed > expected_interval_sec * 3) {
+        MQTT_LOG("[Health] Detected unusual delay: " << elapsed 
+                 << " seconds (expected ~" << expected_interval_sec 
+                 << "s) - possible sleep/resume");
+        last_check_time_ = now;
+        return true;
+    }
+    
+    last_check_time_ = now;
+    return false;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::check_connection_health() {
+    // Sleep 복구 감지
+    bool sleep_detected = detect_sleep_resume();
+    
+    if (!connected_.load()) {
+        return;  // 이미 연결 끊김 상태
+    }
+    
+    // Paho의 연결 상태 확인
+    int is_connected = MQTTAsync_isConnected(client_);
+    
+    if (!is_connected) {
+        MQTT_LOG("[Health] Connection lost detected by isConnected()");
+        connected_.store(false);
+        emit(MQTTEvent(EventType::CONNECTION_LOST, 
+                                    "Stale connection detected"));
+        // 자동 재연결이 작동할 것임
+        return;
+    }
+    
+    // Sleep 복구 후 명시적 확인
+    if (sleep_detected) {
+        MQTT_LOG("[Health] Sleep detected - verifying connection...");
+        
+        // 활동이 오래 없었는지 확인
+        std::lock_guard<std::mutex> lock(activity_mutex_);
+        auto now = std::chrono::steady_clock::now();
+        auto no_activity_sec = std::chrono::duration_cast<std::chrono::seconds>(
+            now - last_activity_).count();
+        
+        // Keep-alive 간격의 2배 이상 활동 없으면 의심
+        if (no_activity_sec > config_.keep_alive_seconds * 2) {
+            MQTT_LOG("[Health] No activity for " << no_activity_sec 
+                     << " seconds - forcing reconnect");
+            
+            connected_.store(false);
+            
+            // 명시적 재연결 (자동 재연결 대신)
+            std::thread([this]() {
+                MQTT_LOG("[Health] Disconnecting stale connection...");
+                
+                MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer;
+                disc_opts.timeout = 1000;
+                MQTTAsync_disconnect(client_, &disc_opts);
+                
+                std::this_thread::sleep_for(std::chrono::seconds(2));
+                
+                MQTT_LOG("[Health] Attempting reconnect...");
+                // 자동 재연결이 작동하도록 놔둠
+            }).detach();
+        }
+    }
+    
+    // 정상 활동 기록
+    update_last_activity();
+}
+#endif // MQTT_FEATURE_HEALTH_CHECK
+
+// ============================================================================
+// MQTT 연결
+// ============================================================================
+template <class Policy>
+bool BasicMQTTClient<Policy>::connect_to_broker() {
+    conn_ = std::make_unique<Connection>();
+    conn_->owner = this;
+    conn_->connect_permit.store(true);  // poll_once() 에서 받은 스케줄러 허가
+    // 콜백이 연결 직후 호출될 수 있으므로 활성 연결을 먼저 지정
+    active_conn_.store(conn_.get());
+
+    if (!open_connection(*conn_, config_, config_.client_id)) {
+        active_conn_.store(nullptr);
+        release_connect_permit(*conn_, false);
+        conn_.reset();
+        return false;
+    }
+    client_ = conn_->handle;
+    return true;
+}
+
+template <class Policy>
+bool BasicMQTTClient<Policy>::open_connection(Connection& conn, const MQTTConfig& config,
+                                              const std::string& client_id) {
+    // 빌드에서 제외된 전송 방식
+    if ((config.use_ssl && !features::tls) || (config.use_websockets && !features::websockets)) {
+        MQTT_LOG_ERROR("[MQTT] Transport not supported by this build: " << config.get_protocol_string());
+        emit(MQTTEvent(EventType::ERROR, "Transport not supported by this build: " + config.get_protocol_string()));
+        return false;
+    }
+
+    // Server URI 생성
+    std::string server_uri;
+    std::string protocol = config.get_protocol_string();
+    
+    if (features::websockets && config.use_websockets) {
+        server_uri = protocol + "://" + config.broker_host + ":" + 
+                     std::to_string(config.broker_port) + config.websocket_path;
+    } else {
+        server_uri = protocol + "://" + config.broker_host + ":" + 
+                     std::to_string(config.broker_port);
+    }
+    
+    // MQTT 클라이언트 생성
+    MQTT_LOG("[MQTT] Creating client: " << server_uri);
+    MQTT_LOG("[MQTT] Protocol: " << protocol 
+             << " (WebSocket: " << (config.use_websockets ? "Yes" : "No")
+             << ", SSL: " << (config.use_ssl ? "Yes" : "No") << ")");
+    
+    conn.client_id = client_id;
+    int rc = MQTTAsync_create(&conn.handle, server_uri.c_str(), conn.client_id.c_str(),
+                              MQTTCLIENT_PERSISTENCE_NONE, nullptr);
+    if (rc != MQTTASYNC_SUCCESS) {
+        emit(MQTTEvent(EventType::ERROR, "Failed to create MQTT client"));
+        conn.handle = nullptr;
+        return false;
+    }
+    
+    // 콜백 설정
+    rc = MQTTAsync_setCallbacks(conn.handle, &conn, on_connection_lost, 
+                                on_message_arrived, on_delivery_complete);
+    if (rc != MQTTASYNC_SUCCESS) {
+        emit(MQTTEvent(EventType::ERROR, "Failed to set callbacks"));
+        MQTTAsync_destroy(&conn.handle);
+        return false;
+    }
+
+    // 자동 재연결 직전마다 공급자의 최신 토큰 적용
+    conn.credentials = config.credential_provider;
+    if (conn.credentials) {
+        MQTTAsync_setUpdateConnectOptions(conn.handle, &conn, on_update_connect_options);
+    }
+    
+    // 연결 옵션 설정
+    MQTTAsync_connectOptions conn_opts = MQTTAsync_connectOptions_initializer;
+    conn_opts.keepAliveInterval = config.keep_alive_seconds;
+    conn_opts.cleansession = 1;
+    conn_opts.automaticReconnect = 1; // 자동 재연결 활성화
+    conn_opts.minRetryInterval = config.min_retry_interval;
+    conn_opts.maxRetryInterval = config.max_retry_interval;
+    conn_opts.onSuccess = on_connect_success;
+    conn_opts.onFailure = on_connect_failure;
+    conn_opts.context = &conn;
+
+#if MQTT_FEATURE_WEBSOCKETS
+    // WebSocket 핸드셰이크 추가 헤더
+    conn.websocket = config.use_websockets;
+    if (config.use_websockets && !config.websocket_headers.empty()) {
+        conn.header_storage.assign(config.websocket_headers.begin(), config.websocket_headers.end());
+        conn.http_headers.clear();
+        for (const auto& [name, value] : conn.header_storage) {
+            conn.http_headers.push_back({name.c_str(), value.c_str()});
+        }
+        conn.http_headers.push_back({nullptr, nullptr});
+        conn_opts.httpHeaders = conn.http_headers.data();
+    }
+#endif
+
+    // HTTP 프록시 (CONNECT 터널)
+    conn.proxy_url = resolve_proxy_url(config);
+    if (!conn.proxy_url.empty()) {
+        if (config.use_ssl) {
+            conn_opts.httpsProxy = conn.proxy_url.c_str();
+        } else {
+            conn_opts.httpProxy = conn.proxy_url.c_str();
+        }
+        MQTT_LOG("[MQTT] Connecting through HTTP proxy");
+    }
+    
+#if MQTT_FEATURE_TLS
+    // SSL 설정
+    MQTTAsync_SSLOptions ssl_opts = MQTTAsync_SSLOptions_initializer;
+    std::string cert_file;
+    if (config.use_ssl) {
+        try {
+            cert_file = setup_ssl_cert(config);
+            ssl_opts.trustStore = cert_file.c_str();
+            ssl_opts.enableServerCertAuth = 1;
+            if (config.has_client_certificate()) {
+                const ClientIdentity& identity = setup_client_identity(config);
+                ssl_opts.keyStore = identity.cert_path.c_str();
+                ssl_opts.privateKey = identity.key_path.c_str();
+                if (identity.key_password.has_value()) {
+                    ssl_opts.privateKeyPassword = identity.key_password->c_str();
+                }
+                MQTT_LOG("[MQTT] Client certificate (mTLS) enabled");
+            }
+            conn_opts.ssl = &ssl_opts;
+            MQTT_LOG("[MQTT] SSL/TLS enabled");
+        } catch (const std::exception& e) {
+            MQTT_LOG_ERROR("[MQTT] SSL setup failed: " << e.what());
+            MQTTAsync_destroy(&conn.handle);
+            return false;
+        }
+    } else {
+        MQTT_LOG("[MQTT] SSL/TLS disabled (insecure connection)");
+    }
+#endif
+    
+    std::optional<Credentials> credentials;
+    if (conn.credentials) {
+        credentials = conn.credentials->current();
+    }
+    if (credentials.has_value()) {
+        conn_opts.username = credentials->username.c_str();
+        conn_opts.password = credentials->password.c_str();
+    } else {
+        if (config.username.has_value()) {
+            conn_opts.username = config.username.value().c_str();
+        }
+        if (config.password.has_value()) {
+            conn_opts.password = config.password.value().c_str();
+        }
+    }
+    
+    MQTT_LOG("[MQTT] Connecting to broker...");
+    conn.connect_started = std::chrono::steady_clock::now();
+    rc = MQTTAsync_connect(conn.handle, &conn_opts);
+    if (rc != MQTTASYNC_SUCCESS) {
+        emit(MQTTEvent(EventType::ERROR, "Failed to start connect"));
+        MQTTAsync_destroy(&conn.handle);
+        return false;
+    }
+    
+    return true;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::close_connection(Connection& conn) {
+    purge_in_flight(&conn);
+    if (!conn.handle) {
+        conn.closed.store(true);
+        return;
+    }
+    // 비동기 disconnect - 진행 중인 전송은 timeout 동안 마무리됨
+    // 완료 콜백에서 closed 가 설정되면 reap_closed_connections() 가 핸들을 해제한다
+    MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer;
+    disc_opts.timeout = 1000;
+    disc_opts.onSuccess = on_disconnect_complete;
+    disc_opts.onFailure = on_disconnect_failure;
+    disc_opts.context = &conn;
+    if (MQTTAsync_disconnect(conn.handle, &disc_opts) != MQTTASYNC_SUCCESS) {
+        conn.closed.store(true);  // 이미 끊긴 연결
+    }
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::reap_closed_connections() {
+    auto now = std::chrono::steady_clock::now();
+    for (auto it = closing_.begin(); it != closing_.end();) {
+        Connection& conn = **it;
+        if (!conn.disconnect_requested) {
+            // 드레인: 미완료 전송 토큰이 없거나 제한 시간이 지나면 disconnect
+            MQTTAsync_token* tokens = nullptr;
+            bool pending = conn.handle &&
+                           MQTTAsync_getPendingTokens(conn.handle, &tokens) == MQTTASYNC_SUCCESS &&
+                           tokens && tokens[0] != -1;
+            if (tokens) {
+                MQTTAsync_free(tokens);
+            }
+            if (pending && conn.connected.load() && now < conn.drain_deadline) {
+                ++it;
+                continue;
+            }
+            conn.disconnect_requested = true;
+            close_connection(conn);
+        }
+        if (conn.closed.load()) {
+            MQTTAsync_destroy(&(*it)->handle);
+            it = closing_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::disconnect_from_broker() {
+    active_conn_.store(nullptr);
+
+    std::vector<std::unique_ptr<Connection>> all = std::move(closing_);
+    closing_.clear();
+    if (conn_) all.push_back(std::move(conn_));
+    if (standby_) all.push_back(std::move(standby_));
+
+    for (auto& conn : all) {
+        release_connect_permit(*conn, false);
+        if (conn->handle) {
+            MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer;
+            disc_opts.timeout = 1000;
+            MQTTAsync_disconnect(conn->handle, &disc_opts);
+            MQTTAsync_destroy(&conn->handle);
+        }
+        purge_in_flight(conn.get());
+    }
+    client_ = nullptr;
+    
+#if MQTT_FEATURE_TLS
+    remove_client_identity_files();
+    release_trust_store();
+#endif
+}
+
+// ============================================================================
+// 설정 변경 / 연결 전환 (make-before-break)
+// ============================================================================
+template <class Policy>
+void BasicMQTTClient<Policy>::update_config(const MQTTConfig& config) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    pending_config_ = config;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::release_connect_permit(Connection& conn, bool success) {
+    if (conn.connect_permit.exchange(false)) {
+        ConnectScheduler::global().release(success);
+    }
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::migrate_to(const std::string& host, int port) {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    MQTTConfig next = pending_config_.has_value() ? pending_config_.value() : config_;
+    next.broker_host = host;
+    next.broker_port = port;
+    pending_config_ = std::move(next);
+    force_reconnect_ = true;
+}
+
+template <class Policy>
+bool BasicMQTTClient<Policy>::credentials_ready(const MQTTConfig& config) {
+    return !config.credential_provider || config.credential_provider->current().has_value();
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::apply_pending_config() {
+    std::optional<MQTTConfig> next;
+    bool force_reconnect = false;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        // 새 공급자의 첫 토큰이 준비될 때까지 적용을 미룸 (연결이 토큰 발급을 기다리지 않도록)
+        if (!pending_config_.has_value() || !credentials_ready(pending_config_.value())) {
+            return;
+        }
+        next.swap(pending_config_);
+        std::swap(force_reconnect, force_reconnect_);
+    }
+    if (next->client_id.empty()) {
+        next->client_id = config_.client_id;
+    }
+
+    // 아직 연결 전이거나 연결 설정이 같으면 바로 적용
+    if (!conn_ || (!force_reconnect && config_.same_connection_settings(next.value()))) {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        config_ = std::move(next.value());
+        MQTT_LOG("[Config] Configuration updated in place");
+        return;
+    }
+
+    // 이전 전환 요청이 진행 중이면 폐기하고 최신 설정으로 다시 시작
+    if (standby_) {
+        MQTT_LOG("[Config] Superseding pending connection switch");
+        standby_->disconnect_requested = true;
+        close_connection(*standby_);
+        closing_.push_back(std::move(standby_));
+    }
+
+    MQTT_LOG("[Config] Connection settings changed - opening new connection");
+    auto standby = std::make_unique<Connection>();
+    standby->owner = this;
+    if (!open_connection(*standby, next.value(), standby_client_id(next->client_id))) {
+        emit(MQTTEvent(EventType::ERROR,
+                                    "Config update failed: could not open new connection"));
+        abandon_standby();
+        return;
+    }
+    standby_config_ = std::move(next.value());
+    standby_ = std::move(standby);
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::check_standby_connection() {
+    if (!standby_) {
+        return;
+    }
+
+    // 전환 중 현재 연결이 끊기면 자동 재연결을 멈춘다 (대기 연결이 이어받음)
+    // Paho 는 연결 후 자동 재연결만 끌 수 없으므로 disconnect 로 재시도를 중단 (첫 재시도는 min_retry_interval 뒤)
+    if (!conn_->reconnect_stopped && !conn_->connected.load()) {
+        MQTT_LOG("[Config] Current connection lost during switch - stopping its reconnect");
+        conn_->reconnect_stopped = true;
+        release_connect_permit(*conn_, false);
+        MQTTAsync_disconnectOptions disc_opts = MQTTAsync_disconnectOptions_initializer;
+        disc_opts.timeout = 0;
+        MQTTAsync_disconnect(conn_->handle, &disc_opts);
+    }
+
+    // 구독 복원 중 대기 연결이 끊기면 clean session 이라 복원한 구독이 사라진다
+    // 자동 재연결로 다시 붙게 두지 않고 실패로 처리
+    if (standby_->restore_started && !standby_->connected.load()) {
+        standby_->failed.store(true);
+    }
+
+    if (standby_->failed.load()) {
+        MQTT_LOG_ERROR("[Config] New connection failed - keeping current connection");
+        emit(MQTTEvent(EventType::ERROR,
+                                    "Config update failed: new connection could not be established"));
+        standby_->disconnect_requested = true;
+        close_connection(*standby_);
+        closing_.push_back(std::move(standby_));
+        abandon_standby();
+        return;
+    }
+
+    if (!standby_->connected.load()) {
+        return;  // 연결 대기 중 - 기존 연결로 계속 처리
+    }
+
+    // 전환 전에 새 연결에 구독 복원
+    if (!standby_->restore_started) {
+        standby_->restore_started = true;
+        if (!restore_subscriptions(*standby_)) {
+            standby_->failed.store(true);
+            return;
+        }
+    }
+    if (standby_->pending_subscriptions.load() > 0) {
+        return;  // SUBACK 대기 중
+    }
+
+    // 새 연결로 전환: 이후 process_requests() 는 새 핸들로 작업을 보낸다
+    // work_queue_ 는 그대로 유지되므로 대기 중인 작업은 새 연결로 전송됨
+    std::unique_ptr<Connection> old = std::move(conn_);
+    conn_ = std::move(standby_);
+    client_ = conn_->handle;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        config_ = std::move(standby_config_);
+    }
+    active_conn_.store(conn_.get());
+    connected_.store(true);
+    update_last_activity();
+
+    // 이전 연결은 진행 중인 전송이 끝날 때까지 드레인 후 닫음 (reap_closed_connections)
+    old->drain_deadline = std::chrono::steady_clock::now() +
+                          std::chrono::milliseconds(config_.migration_drain_timeout_ms);
+    closing_.push_back(std::move(old));
+
+    // 구독은 전환 전에 복원했으므로 연결 리스너(재구독)는 호출하지 않음
+    MQTT_LOG("[Config] Switched to new connection");
+    emit(MQTTEvent(EventType::CONNECTED, "Connected to broker (connection switched)"));
+}
+
+// 활성 연결과 같은 ID 로 CONNECT 하면 브로커가 기존 연결을 끊고 (세션 인계),
+// 기존 연결의 자동 재연결이 다시 대기 연결을 끊는 일이 반복된다
+// 설정 ID 와 설정 ID + "-standby" 를 전환마다 번갈아 사용
+template <class Policy>
+std::string BasicMQTTClient<Policy>::standby_client_id(const std::string& configured) const {
+    return conn_->client_id == configured ? configured + "-standby" : configured;
+}
+
+// 전환 실패 - 현재 연결로 계속한다
+// 전환 중 현재 연결이 끊겨 자동 재연결을 멈췄다면 현재 설정으로 새 연결을 다시 연다
+template <class Policy>
+void BasicMQTTClient<Policy>::abandon_standby() {
+    if (!conn_->reconnect_stopped) {
+        return;
+    }
+    MQTT_LOG("[Config] Reconnecting with current settings");
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    if (!pending_config_.has_value()) {
+        pending_config_ = config_;
+    }
+    force_reconnect_ = true;
+}
+
+template <class Policy>
+bool BasicMQTTClient<Policy>::restore_subscriptions(Connection& conn) {
+    std::map<std::string, int> subscriptions;
+    {
+        std::lock_guard<std::mutex> lock(work_mutex_);
+        subscriptions = subscriptions_;
+    }
+    if (subscriptions.empty()) {
+        return true;
+    }
+
+    MQTT_LOG("[Config] Restoring " << subscriptions.size()
+             << " subscription(s) on new connection");
+    conn.pending_subscriptions.store(static_cast<int>(subscriptions.size()));
+    for (const auto& [topic, qos] : subscriptions) {
+        MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+        opts.onSuccess = on_subscribe_success;
+        opts.onFailure = on_subscribe_failure;
+        opts.context = &conn;
+        if (MQTTAsync_subscribe(conn.handle, topic.c_str(), qos, &opts) != MQTTASYNC_SUCCESS) {
+            MQTT_LOG_ERROR("[Config] Failed to restore subscription: " << topic);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::run() {
+    MQTT_LOG("[Thread] MQTT thread started");
+
+    while (poll_once()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+template <class Policy>
+bool BasicMQTTClient<Policy>::poll_once() {
+    switch (run_state_) {
+        case RunState::IDLE:
+            if (flight_recorder_ && !flight_recorder_->is_open()) {
+                flight_recorder_->open();  // 실패해도 기록 없이 계속 진행
+            }
+
+            // 브로커 연결을 기다리지 않고 캐시된 retained 값부터 전달
+            publish_retained_snapshot();
+
+            // 시작 전에 요청된 설정 변경 반영
+            apply_pending_config();
+
+            // 자격 증명 공급자의 첫 토큰 대기 (발급은 공급자 스레드에서 진행)
+            if (!credentials_ready(config_)) {
+                MQTT_LOG("[Auth] Waiting for initial credentials...");
+            }
+            run_state_ = RunState::WAITING_CREDENTIALS;
+            [[fallthrough]];
+
+        case RunState::WAITING_CREDENTIALS:
+            if (should_stop_.load()) {
+                if (connect_queued_) {
+                    ConnectScheduler::global().cancel();
+                    connect_queued_ = false;
+                }
+                MQTT_LOG("[Thread] MQTT thread stopped");
+                run_state_ = RunState::STOPPED;
+                return false;
+            }
+            if (!credentials_ready(config_)) {
+                return true;
+            }
+
+            // 프로세스 공용 스케줄러에서 차례 대기 (동시 핸드셰이크 수 / 초당 연결 수 제한)
+            if (!connect_queued_) {
+                ConnectScheduler::global().enqueue();
+                connect_queued_ = true;
+                connect_queued_at_ = std::chrono::steady_clock::now();
+            }
+            if (!ConnectScheduler::global().try_acquire(connect_queued_at_)) {
+                return true;
+            }
+            connect_queued_ = false;
+            connect_wait_ms_.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - connect_queued_at_).count());
+
+            if (!connect_to_broker()) {
+                MQTT_LOG_ERROR("[Thread] Failed to connect to broker");
+                run_state_ = RunState::STOPPED;
+                return false;
+            }
+#if MQTT_FEATURE_HEALTH_CHECK
+            last_health_check_ = std::chrono::steady_clock::now();
+#endif
+            run_state_ = RunState::RUNNING;
+            return true;
+
+        case RunState::RUNNING:
+            break;
+
+        case RunState::STOPPED:
+            return false;
+    }
+
+    if (should_stop_.load()) {
+        MQTT_LOG("[Thread] Disconnecting...");
+        disconnect_from_broker();
+        connected_.store(false);
+        MQTT_LOG("[Thread] MQTT thread stopped");
+        run_state_ = RunState::STOPPED;
+        return false;
+    }
+
+    apply_pending_config();
+    check_standby_connection();
+    reap_closed_connections();
+    process_requests();
+
+    // 순서 대기 중인 누락 번호 시간 초과 처리
+    if (sequencer_) {
+        sequencer_->poll([this](MQTTEvent&& event) { emit_sequenced(std::move(event)); });
+    }
+    
+#if MQTT_FEATURE_HEALTH_CHECK
+    auto now = std::chrono::steady_clock::now();
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        now - last_health_check_).count();
+    
+    if (elapsed_ms >= config_.connection_check_interval_ms) {
+        check_connection_health();
+        last_health_check_ = now;
+    }
+#endif
+    return true;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::stop() {
+    MQTT_LOG("[Thread] Stop requested");
+    should_stop_.store(true);
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::process_requests() {
+    AllocScope alloc_scope(AllocSite::DISPATCH);
+    std::lock_guard<std::mutex> lock(work_mutex_);
+
+    // 연결 끊김으로 완료되지 못한 발행부터 원래 발행 순서대로 다시 보냄
+    decltype(resend_) resend;
+    if (connected_.load()) {
+        std::lock_guard<std::mutex> in_flight_lock(in_flight_mutex_);
+        resend.swap(resend_);
+    }
+    
+    while ((!resend.empty() || !work_queue_.empty()) && connected_.load()) {
+        WorkItem item;
+        if (!resend.empty()) {
+            item = std::move(resend.begin()->second);
+            resend.erase(resend.begin());
+        } else {
+            item = work_queue_.front();
+            work_queue_.pop();
+        }
+
+        if (flight_recorder_) {
+            auto kind = item.type == WorkItem::Type::SUBSCRIBE ? JournalRecord::Kind::SUBSCRIBE
+                      : item.type == WorkItem::Type::PUBLISH   ? JournalRecord::Kind::PUBLISH
+                                                               : JournalRecord::Kind::UNSUBSCRIBE;
+            flight_recorder_->record_outbound(kind, item.topic, item.payload, item.qos, item.retained);
+        }
+        
+        switch (item.type) {
+            case WorkItem::Type::SUBSCRIBE: {
+                MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+                opts.onSuccess = on_subscribe_success;
+                opts.onFailure = on_subscribe_failure;
+                opts.context = conn_.get();
+                
+                int rc = MQTTAsync_subscribe(client_, item.topic.c_str(), item.qos, &opts);
+                if (rc != MQTTASYNC_SUCCESS) {
+                    emit(MQTTEvent(EventType::SUBSCRIBE_FAILURE, 
+                                               "Subscribe request failed: " + item.topic));
+                }
+                break;
+            }
+            case WorkItem::Type::PUBLISH: {
+                size_t packet_size = detail::publish_packet_size(item.topic.size(), item.payload.size(), item.qos);
+                if (features::websockets && config_.use_websockets && config_.websocket_max_frame_size > 0 &&
+                    packet_size > config_.websocket_max_frame_size) {
+                    frames_rejected_.fetch_add(1, std::memory_order_relaxed);
+#ifdef MQTT_ENABLE_TRACING
+                    if (tracer_) {
+                        tracer_->finish(item.trace, "mqtt.publish", item.topic, false);
+                    }
+#endif
+                    emit(MQTTEvent(EventType::PUBLISH_FAILURE,
+                                               "Publish exceeds WebSocket frame size limit: " + item.topic));
+                    break;
+                }
+
+                MQTTAsync_message pubmsg = MQTTAsync_message_initializer;
+                pubmsg.payload = const_cast<char*>(item.payload.c_str());
+                pubmsg.payloadlen = static_cast<int>(item.payload.length());
+                pubmsg.qos = item.qos;
+                pubmsg.retained = item.retained;
+                
+                MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+                opts.onSuccess = on_send_success;
+                opts.onFailure = on_send_failure;
+                opts.context = conn_.get();
+                
+                // QoS 1·2 는 완료 콜백보다 먼저 등록되도록 잠근 상태로 전송 (스냅샷용 추적)
+                std::unique_lock<std::mutex> in_flight_lock(in_flight_mutex_, std::defer_lock);
+                bool traced = false;
+#ifdef MQTT_ENABLE_TRACING
+                traced = tracer_ && item.trace.sampled();
+                int64_t send_start = traced ? Tracer::now_ns() : 0;
+#endif
+                if (item.qos > 0 || traced) {
+                    in_flight_lock.lock();
+                }
+                int rc = MQTTAsync_sendMessage(client_, item.topic.c_str(), &pubmsg, &opts);
+                if (rc == MQTTASYNC_SUCCESS && item.qos > 0) {
+                    in_flight_.emplace(std::make_pair(conn_.get(), opts.token),
+                                       InFlight{next_publish_sequence_++, item});
+                }
+#ifdef MQTT_ENABLE_TRACING
+                int64_t send_end = 0;
+                if (traced) {
+                    send_end = Tracer::now_ns();
+                    if (rc == MQTTASYNC_SUCCESS) {
+                        TraceContext trace = item.trace;
+                        trace.mark_ns = send_end;
+                        traced_sends_.emplace(std::make_pair(conn_.get(), opts.token),
+                                              std::make_pair(item.topic, trace));
+                    }
+                }
+#endif
+                if (in_flight_lock.owns_lock()) {
+                    in_flight_lock.unlock();
+                }
+#ifdef MQTT_ENABLE_TRACING
+                if (traced) {
+                    bool sent = rc == MQTTASYNC_SUCCESS;
+                    tracer_->span(item.trace, "mqtt.publish.queue", item.trace.mark_ns, send_start, item.topic);
+                    tracer_->span(item.trace, "mqtt.publish.send", send_start, send_end, item.topic, sent);
+                    if (!sent) {
+                        tracer_->finish(item.trace, "mqtt.publish", item.topic, false);
+                    }
+                }
+#endif
+                if (rc != MQTTASYNC_SUCCESS) {
+                    emit(MQTTEvent(EventType::PUBLISH_FAILURE,
+                                               "Publish request failed: " + item.topic));
+                } else {
+#if MQTT_FEATURE_METRICS
+                    size_t wire_size = packet_size;
+#if MQTT_FEATURE_WEBSOCKETS
+                    if (config_.use_websockets) {
+                        wire_size += detail::websocket_header_size(packet_size, true);
+                    }
+#endif
+                    messages_sent_.fetch_add(1, std::memory_order_relaxed);
+                    bytes_sent_.fetch_add(wire_size, std::memory_order_relaxed);
+                    if (topic_stats_) {
+                        topic_stats_->record(TopicStats::Direction::OUTBOUND, item.topic, wire_size);
+                    }
+#endif
+                }
+                break;
+            }
+            case WorkItem::Type::UNSUBSCRIBE: {
+                MQTTAsync_responseOptions opts = MQTTAsync_responseOptions_initializer;
+                opts.context = conn_.get();
+                MQTTAsync_unsubscribe(client_, item.topic.c_str(), &opts);
+                break;
+            }
+        }
+    }
+
+    // 다시 보내기 전에 끊긴 발행은 다음 연결을 기다림
+    if (!resend.empty()) {
+        std::lock_guard<std::mutex> in_flight_lock(in_flight_mutex_);
+        resend_.merge(resend);
+    }
+}
+
+template <class Policy>
+HookId BasicMQTTClient<Policy>::add_message_interceptor(MessageInterceptor interceptor) {
+    std::unique_lock<std::shared_mutex> lock(hooks_mutex_);
+    HookId id = next_hook_id_++;
+    interceptors_.emplace_back(id, std::move(interceptor));
+    return id;
+}
+
+template <class Policy>
+HookId BasicMQTTClient<Policy>::add_connect_listener(ConnectListener listener) {
+    std::unique_lock<std::shared_mutex> lock(hooks_mutex_);
+    HookId id = next_hook_id_++;
+    connect_listeners_.emplace_back(id, std::move(listener));
+    return id;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::remove_message_interceptor(HookId id) {
+    std::unique_lock<std::shared_mutex> lock(hooks_mutex_);
+    interceptors_.erase(std::remove_if(interceptors_.begin(), interceptors_.end(),
+                                       [id](const auto& hook) { return hook.first == id; }),
+                        interceptors_.end());
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::remove_connect_listener(HookId id) {
+    std::unique_lock<std::shared_mutex> lock(hooks_mutex_);
+    connect_listeners_.erase(std::remove_if(connect_listeners_.begin(), connect_listeners_.end(),
+                                            [id](const auto& hook) { return hook.first == id; }),
+                             connect_listeners_.end());
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::emit(MQTTEvent&& event, bool latest) {
+    AllocScope alloc_scope(AllocSite::EVENT);
+    if (flight_recorder_) {
+        flight_recorder_->record_event(event);
+    }
+    if (latest) {
+        event_queue_.push_latest(std::move(event));
+    } else {
+        event_queue_.push(std::move(event));
+    }
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::notify_connected() {
+    std::shared_lock<std::shared_mutex> lock(hooks_mutex_);
+    for (const auto& [id, listener] : connect_listeners_) {
+        listener();
+    }
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::inject_message(std::string_view topic, std::string_view payload, int qos, bool retained) {
+    // Paho 와 같은 방식으로 할당 (콜백이 MQTTAsync_free / MQTTAsync_freeMessage 로 해제)
+    auto* message = static_cast<MQTTAsync_message*>(MQTTAsync_malloc(sizeof(MQTTAsync_message)));
+    *message = MQTTAsync_message_initializer;
+    message->payload = MQTTAsync_malloc(payload.size() + 1);
+    std::memcpy(message->payload, payload.data(), payload.size());
+    message->payloadlen = static_cast<int>(payload.size());
+    message->qos = qos;
+    message->retained = retained ? 1 : 0;
+    auto* topic_name = static_cast<char*>(MQTTAsync_malloc(topic.size() + 1));
+    std::memcpy(topic_name, topic.data(), topic.size());
+    topic_name[topic.size()] = '\0';
+
+    injected_.owner = this;
+    on_message_arrived(&injected_, topic_name, static_cast<int>(topic.size()), message);
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::publish_retained_snapshot() {
+    if (!retained_cache_) {
+        return;
+    }
+    if (!retained_cache_->is_open() && !retained_cache_->open()) {
+        return;  // 캐시 없이 브로커 재전송에 의존
+    }
+    size_t count = 0;
+    retained_cache_->for_each([this, &count](const std::string& topic, const std::string& payload) {
+        MQTTEvent event(EventType::MESSAGE_ARRIVED, topic, payload);
+        event.retained = true;
+        event.from_snapshot = true;
+        if (last_value_cache_ && last_value_cache_->accepts(topic)) {
+            last_value_cache_->update(topic, payload);
+        }
+        emit(std::move(event));
+        ++count;
+    });
+    MQTT_LOG("[Retained] Delivered " << count << " cached value(s) from snapshot");
+}
+
+template <class Policy>
+ClientStats BasicMQTTClient<Policy>::get_stats() const {
+    ClientStats stats;
+    stats.connect_count = connect_count_.load();
+    stats.last_connect_time = std::chrono::milliseconds(last_connect_ms_.load());
+    stats.connect_wait = std::chrono::milliseconds(connect_wait_ms_.load());
+    stats.last_connect_via_proxy = last_connect_via_proxy_.load();
+    stats.messages_sent = messages_sent_.load(std::memory_order_relaxed);
+    stats.bytes_sent = bytes_sent_.load(std::memory_order_relaxed);
+    stats.messages_received = messages_received_.load(std::memory_order_relaxed);
+    stats.bytes_received = bytes_received_.load(std::memory_order_relaxed);
+    stats.frames_rejected = frames_rejected_.load(std::memory_order_relaxed);
+    stats.duplicates_dropped = dedup_filter_ ? dedup_filter_->duplicates() : 0;
+    stats.messages_filtered = delivery_policies_.dropped();
+    stats.messages_conflated = event_queue_.conflated();
+    stats.allocations = allocation_stats();
+    return stats;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::request_subscribe(const std::string& topic, int qos) {
+    AllocScope alloc_scope(AllocSite::ENQUEUE);
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    WorkItem item;
+    item.type = WorkItem::Type::SUBSCRIBE;
+    item.topic = topic;
+    item.qos = qos;
+    work_queue_.push(item);
+    subscriptions_[topic] = qos;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::request_subscribe(const std::string& topic, int qos, const DeliveryPolicy& policy) {
+    delivery_policies_.set(topic, policy);
+    request_subscribe(topic, qos);
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::request_publish(const std::string& topic, const std::string& payload,
+                                 int qos, bool retained) {
+    AllocScope alloc_scope(AllocSite::ENQUEUE);
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    WorkItem item;
+    item.type = WorkItem::Type::PUBLISH;
+    item.topic = topic;
+    item.payload = payload;
+    item.qos = qos;
+    item.retained = retained;
+#ifdef MQTT_ENABLE_TRACING
+    if (tracer_) {
+        item.trace = tracer_->start();
+    }
+#endif
+    work_queue_.push(item);
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::request_unsubscribe(const std::string& topic) {
+    AllocScope alloc_scope(AllocSite::ENQUEUE);
+    std::lock_guard<std::mutex> lock(work_mutex_);
+    WorkItem item;
+    item.type = WorkItem::Type::UNSUBSCRIBE;
+    item.topic = topic;
+    work_queue_.push(item);
+    subscriptions_.erase(topic);
+    delivery_policies_.remove(topic);
+}
+
+// ============================================================================
+// 웜 스타트 스냅샷
+// ============================================================================
+namespace detail {
+
+inline constexpr char kSnapshotMagic[4] = {'M', 'Q', 'S', 'N'};
+inline constexpr uint32_t kSnapshotVersion = 1;
+
+inline void put_u32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+}
+
+inline void put_str(std::string& out, const std::string& value) {
+    put_u32(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+}
+
+// 경계 검사하며 읽기 - 잘린/손상된 파일이면 ok 가 false
+struct SnapshotReader {
+    const std::string& data;
+    size_t pos = 0;
+    bool ok = true;
+
+    uint32_t u32() {
+        if (data.size() - pos < 4) {
+            ok = false;
+            return 0;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            value |= static_cast<uint32_t>(static_cast<unsigned char>(data[pos + i])) << (8 * i);
+        }
+        pos += 4;
+        return value;
+    }
+
+    std::string str() {
+        uint32_t size = u32();
+        if (!ok || data.size() - pos < size) {
+            ok = false;
+            return {};
+        }
+        std::string value = data.substr(pos, size);
+        pos += size;
+        return value;
+    }
+};
+
+} // namespace detail
+
+template <class Policy>
+bool BasicMQTTClient<Policy>::complete_in_flight(const Connection* conn, MQTTAsync_token token, bool success,
+                                                 bool connection_lost) {
+    bool requeued = false;
+#ifdef MQTT_ENABLE_TRACING
+    std::optional<std::pair<std::string, TraceContext>> traced;
+#endif
+    {
+        std::lock_guard<std::mutex> lock(in_flight_mutex_);
+        auto found = in_flight_.find(std::make_pair(conn, token));
+        if (found != in_flight_.end()) {
+            if (!success && connection_lost) {
+                // 연결 끊김/종료 - 브로커 수신 여부를 알 수 없으므로 다음 연결에서 다시 보냄 (최소 1회 전달)
+                WorkItem& item = found->second.item;
+#ifdef MQTT_ENABLE_TRACING
+                item.trace = TraceContext{};  // 첫 전송의 span 은 아래에서 실패로 종료
+#endif
+                resend_.emplace(found->second.sequence, std::move(item));
+                requeued = true;
+            }
+            in_flight_.erase(found);
+        }
+#ifdef MQTT_ENABLE_TRACING
+        auto it = traced_sends_.find(std::make_pair(conn, token));
+        if (it != traced_sends_.end()) {
+            traced = std::move(it->second);
+            traced_sends_.erase(it);
+        }
+#endif
+    }
+#ifdef MQTT_ENABLE_TRACING
+    if (traced && tracer_) {
+        const auto& [topic, trace] = *traced;
+        tracer_->span(trace, "mqtt.publish.ack", trace.mark_ns, Tracer::now_ns(), topic, success);
+        tracer_->finish(trace, "mqtt.publish", topic, success);
+    }
+#else
+    (void)success;
+#endif
+    return requeued;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::purge_in_flight(const Connection* conn) {
+    // 키는 (연결, 토큰) 순이므로 연결별 항목이 연속한다
+    const InFlightKey first(conn, std::numeric_limits<MQTTAsync_token>::min());
+#ifdef MQTT_ENABLE_TRACING
+    std::vector<std::pair<std::string, TraceContext>> traced;
+#endif
+    {
+        std::lock_guard<std::mutex> lock(in_flight_mutex_);
+        auto it = in_flight_.lower_bound(first);
+        while (it != in_flight_.end() && it->first.first == conn) {
+            WorkItem& item = it->second.item;
+#ifdef MQTT_ENABLE_TRACING
+            item.trace = TraceContext{};
+#endif
+            resend_.emplace(it->second.sequence, std::move(item));
+            it = in_flight_.erase(it);
+        }
+#ifdef MQTT_ENABLE_TRACING
+        auto traced_it = traced_sends_.lower_bound(first);
+        while (traced_it != traced_sends_.end() && traced_it->first.first == conn) {
+            traced.push_back(std::move(traced_it->second));
+            traced_it = traced_sends_.erase(traced_it);
+        }
+#endif
+    }
+#ifdef MQTT_ENABLE_TRACING
+    if (tracer_) {
+        for (const auto& [topic, trace] : traced) {
+            tracer_->span(trace, "mqtt.publish.ack", trace.mark_ns, Tracer::now_ns(), topic, false);
+            tracer_->finish(trace, "mqtt.publish", topic, false);
+        }
+    }
+#endif
+}
+
+template <class Policy>
+bool BasicMQTTClient<Policy>::save_snapshot(const std::string& path) const {
+    std::string out(detail::kSnapshotMagic, sizeof(detail::kSnapshotMagic));
+    detail::put_u32(out, detail::kSnapshotVersion);
+
+    // 엔드포인트 / 신뢰 저장소
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        detail::put_str(out, config_.broker_host);
+        detail::put_u32(out, static_cast<uint32_t>(config_.broker_port));
+        detail::put_u32(out, (config_.use_ssl ? 1u : 0u) | (config_.use_websockets ? 2u : 0u));
+        detail::put_str(out, config_.client_id);
+        detail::put_str(out, config_.cert_file_path.value_or(""));
+    }
+#if MQTT_FEATURE_TLS
+    {
+        auto& store = detail::shared_trust_store();
+        std::lock_guard<std::mutex> lock(store.mutex);
+        detail::put_str(out, store.temporary ? "" : store.path);  // 임시 추출 파일은 종료 시 삭제됨
+    }
+#else
+    detail::put_str(out, "");
+#endif
+
+    auto put_item = [&out](const WorkItem& item) {
+        detail::put_u32(out, static_cast<uint32_t>(item.type));
+        detail::put_str(out, item.topic);
+        detail::put_str(out, item.payload);
+        detail::put_u32(out, static_cast<uint32_t>(item.qos));
+        detail::put_u32(out, item.retained ? 1u : 0u);
+    };
+
+    // 전송 중 발행 (다시 보낼 발행 포함) - in_flight_ 는 연결별 토큰 순이므로 발행 순번으로 정렬
+    {
+        std::lock_guard<std::mutex> lock(in_flight_mutex_);
+        std::map<uint64_t, const WorkItem*> ordered;
+        for (const auto& [key, in_flight] : in_flight_) {
+            ordered.emplace(in_flight.sequence, &in_flight.item);
+        }
+        for (const auto& [sequence, item] : resend_) {
+            ordered.emplace(sequence, &item);
+        }
+        detail::put_u32(out, static_cast<uint32_t>(ordered.size()));
+        for (const auto& [sequence, item] : ordered) {
+            put_item(*item);
+        }
+    }
+    // 구독 레지스트리 / 대기 작업
+    {
+        std::lock_guard<std::mutex> lock(work_mutex_);
+        detail::put_u32(out, static_cast<uint32_t>(subscriptions_.size()));
+        for (const auto& [topic, qos] : subscriptions_) {
+            detail::put_str(out, topic);
+            detail::put_u32(out, static_cast<uint32_t>(qos));
+        }
+        WorkQueue pending = work_queue_;
+        detail::put_u32(out, static_cast<uint32_t>(pending.size()));
+        for (; !pending.empty(); pending.pop()) {
+            put_item(pending.front());
+        }
+    }
+
+    // 임시 파일에 쓴 뒤 교체 (중간에 종료되어도 이전 스냅샷 유지)
+    // 발행 페이로드가 들어 있으므로 소유자 전용 (0600)
+    std::string temp_path = path + ".tmp";
+    if (!detail::write_private_file(temp_path, out)) {
+        MQTT_LOG_ERROR("[Snapshot] Failed to write snapshot: " << temp_path);
+        return false;
+    }
+    if (!detail::replace_file(temp_path, path)) {
+        MQTT_LOG_ERROR("[Snapshot] Failed to replace snapshot: " << path);
+        return false;
+    }
+    MQTT_LOG("[Snapshot] Saved " << out.size() << " bytes to " << path);
+    return true;
+}
+
+template <class Policy>
+bool BasicMQTTClient<Policy>::load_snapshot(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (data.size() < 8 || data.compare(0, 4, detail::kSnapshotMagic, 4) != 0) {
+        MQTT_LOG_ERROR("[Snapshot] Not a snapshot file: " << path);
+        return false;
+    }
+
+    detail::SnapshotReader in{data, 4};
+    if (in.u32() != detail::kSnapshotVersion) {
+        MQTT_LOG_ERROR("[Snapshot] Unsupported snapshot version");
+        return false;
+    }
+
+    std::string host = in.str();
+    int port = static_cast<int>(in.u32());
+    uint32_t flags = in.u32();
+    std::string client_id = in.str();
+    std::string cert_file = in.str();
+    std::string trust_store = in.str();
+
+    auto get_item = [&in]() {
+        WorkItem item;
+        item.type = static_cast<typename WorkItem::Type>(in.u32());
+        item.topic = in.str();
+        item.payload = in.str();
+        item.qos = static_cast<int>(in.u32());
+        item.retained = in.u32() != 0;
+        return item;
+    };
+
+    std::vector<WorkItem> restored;
+    uint32_t in_flight_count = in.u32();
+    for (uint32_t i = 0; i < in_flight_count && in.ok; ++i) {
+        restored.push_back(get_item());
+    }
+    std::map<std::string, int> subscriptions;
+    uint32_t subscription_count = in.u32();
+    for (uint32_t i = 0; i < subscription_count && in.ok; ++i) {
+        std::string topic = in.str();
+        subscriptions[topic] = static_cast<int>(in.u32());
+    }
+    uint32_t pending_count = in.u32();
+    for (uint32_t i = 0; i < pending_count && in.ok; ++i) {
+        restored.push_back(get_item());
+    }
+    if (!in.ok) {
+        MQTT_LOG_ERROR("[Snapshot] Truncated snapshot file: " << path);
+        return false;
+    }
+
+    // 같은 엔드포인트일 때만 식별자/신뢰 저장소 복원 (설정이 바뀌었으면 설정 우선)
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        bool same_endpoint = host == config_.broker_host && port == config_.broker_port &&
+                             ((flags & 1u) != 0) == config_.use_ssl &&
+                             ((flags & 2u) != 0) == config_.use_websockets;
+        if (same_endpoint) {
+            config_.client_id = client_id;
+            if (!config_.cert_file_path.has_value()) {
+                const std::string& trust = !cert_file.empty() ? cert_file : trust_store;
+                if (!trust.empty() && detail::file_exists(trust)) {
+                    config_.cert_file_path = trust;  // 시스템 인증서 탐색 생략
+                }
+            }
+        } else {
+            MQTT_LOG("[Snapshot] Endpoint changed - keeping configured client id / trust store");
+        }
+    }
+
+    // 구독 복원 (cleansession 이므로 다시 구독) 후 전송 중/대기 작업을 기존 작업 앞에 배치
+    {
+        std::lock_guard<std::mutex> lock(work_mutex_);
+        WorkQueue queue;
+        for (const auto& [topic, qos] : subscriptions) {
+            if (subscriptions_.count(topic) == 0) {
+                WorkItem item;
+                item.type = WorkItem::Type::SUBSCRIBE;
+                item.topic = topic;
+                item.qos = qos;
+                item.retained = false;
+                queue.push(std::move(item));
+                subscriptions_[topic] = qos;
+            }
+        }
+        for (auto& item : restored) {
+            if (item.type == WorkItem::Type::SUBSCRIBE && subscriptions.count(item.topic) > 0) {
+                continue;  // 위에서 이미 복원
+            }
+            queue.push(std::move(item));
+        }
+        for (; !work_queue_.empty(); work_queue_.pop()) {
+            queue.push(std::move(work_queue_.front()));
+        }
+        work_queue_.swap(queue);
+    }
+
+    MQTT_LOG("[Snapshot] Restored " << subscriptions.size() << " subscription(s), "
+             << in_flight_count << " in-flight and " << pending_count
+             << " pending request(s) from " << path);
+    return true;
+}
+
+// ============================================================================
+// 콜백 함수들
+// ============================================================================
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_connection_lost(void* context, char* cause) {
+    auto* conn = static_cast<Connection*>(context);
+    auto* client = conn->owner;
+    conn->connected.store(false);
+    std::string cause_str = cause ? std::string(cause) : "Unknown";
+    if (!client->is_active(conn)) {
+        // 전환 중인 이전/대기 연결 - 활성 연결 상태에는 영향 없음
+        MQTT_LOG("[Callback] Inactive connection lost: " << cause_str);
+        return;
+    }
+    client->connected_.store(false);
+    client->emit(MQTTEvent(EventType::CONNECTION_LOST, cause_str));
+    MQTT_LOG("[Callback] Connection lost: " << cause_str);
+}
+
+template <class Policy>
+int BasicMQTTClient<Policy>::on_message_arrived(void* context, char* topicName, int topicLen, MQTTAsync_message* message) {
+    // 전환 중에는 두 연결 모두에서 수신될 수 있으며 모두 전달한다
+    auto* conn = static_cast<Connection*>(context);
+    auto* client = conn->owner;
+    AllocScope alloc_scope(AllocSite::CALLBACK);
+    client->update_last_activity();
+#ifdef MQTT_ENABLE_TRACING
+    TraceContext trace;
+    if (client->tracer_) {
+        trace = client->tracer_->start();
+    }
+#endif
+
+    size_t topic_size = topicLen > 0 ? static_cast<size_t>(topicLen) : std::strlen(topicName);
+    std::string_view topic_view(topicName, topic_size);
+    std::string_view payload_view(static_cast<char*>(message->payload), message->payloadlen);
+#if MQTT_FEATURE_METRICS
+    size_t wire_size = detail::publish_packet_size(topic_size, message->payloadlen, message->qos);
+#if MQTT_FEATURE_WEBSOCKETS
+    if (conn->websocket) {
+        wire_size += detail::websocket_header_size(wire_size, false);
+    }
+#endif
+    client->messages_received_.fetch_add(1, std::memory_order_relaxed);
+    client->bytes_received_.fetch_add(wire_size, std::memory_order_relaxed);
+    if (client->topic_stats_) {
+        client->topic_stats_->record(TopicStats::Direction::INBOUND, topic_view, wire_size);
+    }
+#endif
+
+    // 중복 재전송 제거
+    if (client->dedup_filter_ &&
+        client->dedup_filter_->is_duplicate(topic_view, payload_view, message->msgid, message->dup != 0)) {
+        MQTTAsync_freeMessage(&message);
+        MQTTAsync_free(topicName);
+        return 1;
+    }
+
+    // retained 캐시 갱신 - 시작 시 스냅샷으로 이미 전달한 값과 같으면 건너뜀
+    if (message->retained && client->retained_cache_ &&
+        !client->retained_cache_->update(topic_view, payload_view)) {
+        MQTTAsync_freeMessage(&message);
+        MQTTAsync_free(topicName);
+        return 1;
+    }
+
+    // 가로채기 훅 (RPC 응답 등) - 소비되면 이벤트를 만들지 않음
+    bool intercepted = false;
+    {
+        std::shared_lock<std::shared_mutex> lock(client->hooks_mutex_);
+        for (const auto& [id, interceptor] : client->interceptors_) {
+            if (interceptor(topic_view, payload_view, message->qos)) {
+                intercepted = true;
+                break;
+            }
+        }
+    }
+    if (intercepted) {
+        MQTTAsync_freeMessage(&message);
+        MQTTAsync_free(topicName);
+        return 1;
+    }
+    
+    // 구독별 전달 정책 (내용 조건 / 샘플링) - 버려지는 메시지는 할당/큐잉 없이 반환
+    auto action = client->delivery_policies_.evaluate(topic_view, payload_view);
+
+    // 마지막 값 캐시 - Sequencer 를 거치는 메시지는 배출될 때 갱신하고 (emit_sequenced),
+    // 거치지 않는 메시지도 Sequencer 가 지난 번호로 볼 값이면 새 값을 덮어쓰지 않도록 건너뜀
+    bool sequenced = client->sequencer_ && action == DeliveryPolicies::Action::DELIVER;
+    if (!sequenced && client->last_value_cache_ &&
+        !(client->sequencer_ && client->sequencer_->is_stale(topic_view, payload_view))) {
+        client->update_last_value(topic_view, payload_view, message->retained != 0);
+    }
+
+    if (action == DeliveryPolicies::Action::DROP) {
+        MQTTAsync_freeMessage(&message);
+        MQTTAsync_free(topicName);
+        return 1;
+    }
+    
+    AllocScope event_scope(AllocSite::EVENT);
+    std::string topic(topic_view);
+    std::string payload(payload_view);
+    
+    MQTTEvent event(EventType::MESSAGE_ARRIVED, topic, payload, message->qos);
+    event.retained = message->retained != 0;
+#ifdef MQTT_ENABLE_TRACING
+    if (trace.sampled()) {
+        trace.mark_ns = Tracer::now_ns();
+        client->tracer_->span(trace, "mqtt.receive.callback", trace.start_ns, trace.mark_ns, topic);
+        event.trace = trace;
+    }
+#endif
+    if (action == DeliveryPolicies::Action::CONFLATE) {
+        client->emit(std::move(event), true);
+    } else if (sequenced) {
+        client->sequencer_->process(std::move(event), [client](MQTTEvent&& ordered) {
+            client->emit_sequenced(std::move(ordered));
+        });
+    } else {
+        client->emit(std::move(event));
+    }
+    
+    MQTTAsync_freeMessage(&message);
+    MQTTAsync_free(topicName);
+    return 1;
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::emit_sequenced(MQTTEvent&& event) {
+    if (event.type == EventType::MESSAGE_ARRIVED) {
+        update_last_value(event.topic, event.payload, event.retained);
+    }
+    emit(std::move(event));
+}
+
+// 빈 retained 메시지는 retained 삭제
+template <class Policy>
+void BasicMQTTClient<Policy>::update_last_value(std::string_view topic, std::string_view payload, bool retained) {
+    if (!last_value_cache_ || !last_value_cache_->accepts(topic)) {
+        return;
+    }
+    if (retained && payload.empty()) {
+        last_value_cache_->erase(topic);
+    } else {
+        last_value_cache_->update(topic, payload);
+    }
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_delivery_complete(void* context, MQTTAsync_token token) {
+    auto* client = static_cast<Connection*>(context)->owner;
+    client->update_last_activity();
+    
+    MQTTEvent event(EventType::DELIVERY_COMPLETE);
+    event.token = token;
+    client->emit(std::move(event));
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_connect_success(void* context, MQTTAsync_successData* response) {
+    auto* conn = static_cast<Connection*>(context);
+    auto* client = conn->owner;
+    conn->connected.store(true);
+    release_connect_permit(*conn, true);
+    client->connect_count_.fetch_add(1);
+    if (!conn->connect_timed.exchange(true)) {
+        // 최초 연결의 핸드셰이크 비용 기록 (자동 재연결은 제외)
+        auto elapsed = std::chrono::steady_clock::now() - conn->connect_started;
+        client->last_connect_ms_.store(
+            std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+        client->last_connect_via_proxy_.store(!conn->proxy_url.empty());
+    }
+    if (!client->is_active(conn)) {
+        // 대기 연결 - MQTT 스레드의 check_standby_connection() 에서 전환
+        MQTT_LOG("[Callback] New connection established, switching...");
+        return;
+    }
+    client->connected_.store(true);
+    client->update_last_activity();
+    client->notify_connected();
+    client->emit(MQTTEvent(EventType::CONNECTED, "Connected to broker"));
+    MQTT_LOG("[Callback] Connected successfully ("
+             << client->last_connect_ms_.load() << " ms)");
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_connect_failure(void* context, MQTTAsync_failureData* response) {
+    auto* conn = static_cast<Connection*>(context);
+    auto* client = conn->owner;
+    std::string error_msg = response && response->message ? 
+                           std::string(response->message) : "Unknown error";
+    release_connect_permit(*conn, false);
+    if (!client->is_active(conn)) {
+        conn->failed.store(true);
+        MQTT_LOG_ERROR("[Callback] New connection failed: " << error_msg);
+        return;
+    }
+    client->emit(MQTTEvent(EventType::ERROR, "Connection failed: " + error_msg));
+    MQTT_LOG_ERROR("[Callback] Connection failed: " << error_msg);
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_subscribe_success(void* context, MQTTAsync_successData* response) {
+    auto* conn = static_cast<Connection*>(context);
+    auto* client = conn->owner;
+    if (!client->is_active(conn)) {
+        conn->pending_subscriptions.fetch_sub(1);  // 대기 연결 구독 복원
+        return;
+    }
+    client->emit(MQTTEvent(EventType::SUBSCRIBE_SUCCESS, "Subscription successful"));
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_subscribe_failure(void* context, MQTTAsync_failureData* response) {
+    auto* conn = static_cast<Connection*>(context);
+    auto* client = conn->owner;
+    std::string error_msg = response && response->message ?
+                           std::string(response->message) : "Unknown error";
+    if (!client->is_active(conn)) {
+        // 구독을 복원하지 못하면 전환하지 않음
+        MQTT_LOG_ERROR("[Callback] Subscription restore failed: " << error_msg);
+        conn->failed.store(true);
+        return;
+    }
+    client->emit(MQTTEvent(EventType::SUBSCRIBE_FAILURE, "Subscribe failed: " + error_msg));
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_send_success(void* context, MQTTAsync_successData* response) {
+    auto* conn = static_cast<Connection*>(context);
+    auto* client = conn->owner;
+    if (response) {
+        client->complete_in_flight(conn, response->token, true);
+    }
+    client->emit(MQTTEvent(EventType::PUBLISH_SUCCESS, "Message published"));
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_send_failure(void* context, MQTTAsync_failureData* response) {
+    auto* conn = static_cast<Connection*>(context);
+    auto* client = conn->owner;
+    // 연결 끊김/종료로 중단된 QoS 1·2 발행은 다시 보내므로 실패로 알리지 않음
+    bool connection_lost = response && (response->code == MQTTASYNC_OPERATION_INCOMPLETE ||
+                                        response->code == MQTTASYNC_DISCONNECTED);
+    if (response && client->complete_in_flight(conn, response->token, false, connection_lost)) {
+        MQTT_LOG("[Callback] Publish interrupted by disconnect - will resend");
+        return;
+    }
+    std::string error_msg = response && response->message ?
+                           std::string(response->message) : "Unknown error";
+    client->emit(MQTTEvent(EventType::PUBLISH_FAILURE, "Publish failed: " + error_msg));
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_disconnect_complete(void* context, MQTTAsync_successData* /*response*/) {
+    static_cast<Connection*>(context)->closed.store(true);
+}
+
+template <class Policy>
+void BasicMQTTClient<Policy>::on_disconnect_failure(void* context, MQTTAsync_failureData* /*response*/) {
+    static_cast<Connection*>(context)->closed.store(true);
+}
+
+template <class Policy>
+int BasicMQTTClient<Policy>::on_update_connect_options(void* context, MQTTAsync_connectData* data) {
+    auto* conn = static_cast<Connection*>(context);
+    auto credentials = conn->credentials ? conn->credentials->current() : std::nullopt;
+    if (!credentials.has_value()) {
+        return 0;  // 기존 값 유지
+    }
+
+    // Paho 가 해제하므로 MQTTAsync_malloc 으로 할당해야 함
+    char* username = static_cast<char*>(MQTTAsync_malloc(credentials->username.size() + 1));
+    char* password = static_cast<char*>(MQTTAsync_malloc(credentials->password.size()));
+    if (!username || (!password && !credentials->password.empty())) {
+        MQTTAsync_free(username);
+        MQTTAsync_free(password);
+        return 0;
+    }
+    std::memcpy(username, credentials->username.c_str(), credentials->username.size() + 1);
+    std::memcpy(password, credentials->password.data(), credentials->password.size());
+
+    data->username = username;
+    data->binarypwd.data = password;
+    data->binarypwd.len = static_cast<int>(credentials->password.size());
+    return 1;
+}
+
+} // namespace mqtt_client
@@ -0,0 +1,180 @@
+#include "retained_cache.h"
+#include "log.h"
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+namespace mqtt_client {
+
+RetainedCache::RetainedCache(std::string path, size_t initial_capacity)
+    : path_(std::move(path)), capacity_(std::max(initial_capacity, sizeof(Header) + 4096)) {}
+
+RetainedCache::~RetainedCache() {
+    close();
+}
+
+// ============================================================================
+// 열기 / 닫기
+// ============================================================================
+bool RetainedCache::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (file_.is_open()) {
+        return true;
+    }
+    if (!file_.open(path_, capacity_)) {
+        MQTT_LOG_ERROR("[Retained] Failed to map cache file: " << path_);
+        return false;
+    }
+
+    Header* h = header();
+    bool valid = std::memcmp(h->magic, "MQRC", 4) == 0 && h->version == kVersion && h->active < 2;
+    if (valid) {
+        const Region& region = h->regions[h->active];
+        valid = region.start <= records_size() && region.used <= records_size() - region.start &&
+                region.start + region.used <= region_limit(region);
+    }
+    if (!valid) {
+        // 새 파일 또는 호환되지 않는 형식 (이전 버전 포함) - 초기화
+        std::memset(h, 0, sizeof(Header));
+        std::memcpy(h->magic, "MQRC", 4);
+        h->version = kVersion;
+    }
+    load();
+    MQTT_LOG("[Retained] Loaded " << values_.size() << " cached topic(s) from " << path_);
+    return true;
+}
+
+void RetainedCache::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    file_.close();
+}
+
+void RetainedCache::load() {
+    Region& region = header()->regions[header()->active];
+    const char* begin = records() + region.start;
+    const char* p = begin;
+    const char* end = p + region.used;
+    while (end - p >= 8) {
+        uint32_t topic_len;
+        uint32_t payload_len;
+        std::memcpy(&topic_len, p, 4);
+        std::memcpy(&payload_len, p + 4, 4);
+        size_t body = topic_len + (payload_len == kTombstone ? 0 : payload_len);
+        if (static_cast<size_t>(end - p - 8) < body) {
+            break;  // 손상된 꼬리
+        }
+        std::string topic(p + 8, topic_len);
+        if (payload_len == kTombstone) {
+            values_.erase(topic);
+        } else {
+            values_[std::move(topic)] = std::string(p + 8 + topic_len, payload_len);
+        }
+        p += 8 + body;
+    }
+    region.used = static_cast<uint64_t>(p - begin);
+}
+
+// ============================================================================
+// 갱신
+// ============================================================================
+bool RetainedCache::update(std::string_view topic, std::string_view payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool tombstone = payload.empty();
+    if (tombstone) {
+        if (values_.erase(std::string(topic)) == 0) {
+            return false;
+        }
+    } else {
+        auto it = values_.find(std::string(topic));
+        if (it != values_.end() && it->second == payload) {
+            return false;  // 변경 없음 (재시작/재연결 후 브로커 재전송)
+        }
+        values_[std::string(topic)] = std::string(payload);
+    }
+    if (file_.is_open() && !append(topic, payload, tombstone)) {
+        // 공간 부족 - 살아있는 값으로 다시 기록 (이번 변경 포함)
+        compact();
+    }
+    return true;
+}
+
+bool RetainedCache::append(std::string_view topic, std::string_view payload, bool tombstone) {
+    Region& region = header()->regions[header()->active];
+    size_t record = 8 + topic.size() + (tombstone ? 0 : payload.size());
+    size_t offset = region.start + region.used;
+    if (offset + record > region_limit(region)) {
+        return false;
+    }
+    uint32_t topic_len = static_cast<uint32_t>(topic.size());
+    uint32_t payload_len = tombstone ? kTombstone : static_cast<uint32_t>(payload.size());
+    char* p = records() + offset;
+    std::memcpy(p, &topic_len, 4);
+    std::memcpy(p + 4, &payload_len, 4);
+    std::memcpy(p + 8, topic.data(), topic.size());
+    if (!tombstone) {
+        std::memcpy(p + 8 + topic.size(), payload.data(), payload.size());
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+    region.used += record;  // 레코드 기록 후 커밋
+    return true;
+}
+
+// 살아있는 값만 반대쪽 반에 다시 기록한 뒤 active 를 바꿔 커밋
+// 반쪽에 살아있는 값의 2배가 들어가지 않으면 파일 크기를 2배씩 늘린다
+// (확장 후에도 현재 구간은 새 경계 안쪽 반에 있으므로 새 구간과 겹치지 않음)
+bool RetainedCache::compact() {
+    size_t live = 0;
+    for (const auto& [topic, payload] : values_) {
+        live += 8 + topic.size() + payload.size();
+    }
+    if (live * 4 > records_size()) {
+        size_t new_size = file_.size();
+        while (live * 4 > new_size - sizeof(Header)) {
+            new_size *= 2;
+        }
+        if (!file_.remap(new_size)) {
+            MQTT_LOG_ERROR("[Retained] Failed to grow cache file");
+            return false;
+        }
+        MQTT_LOG("[Retained] Cache file grown to " << new_size << " bytes");
+    }
+
+    Header* h = header();
+    uint32_t next = h->active ^ 1u;
+    const Region& current = h->regions[h->active];
+    h->regions[next].start = current.start < records_size() / 2 ? records_size() / 2 : 0;
+    h->regions[next].used = 0;
+
+    char* p = records() + h->regions[next].start;
+    for (const auto& [topic, payload] : values_) {
+        uint32_t topic_len = static_cast<uint32_t>(topic.size());
+        uint32_t payload_len = static_cast<uint32_t>(payload.size());
+        std::memcpy(p, &topic_len, 4);
+        std::memcpy(p + 4, &payload_len, 4);
+        std::memcpy(p + 8, topic.data(), topic.size());
+        std::memcpy(p + 8 + topic.size(), payload.data(), payload.size());
+        p += 8 + topic.size() + payload.size();
+    }
+    h->regions[next].used = live;
+    std::atomic_thread_fence(std::memory_order_release);
+    h->active = next;  // 단일 쓰기로 커밋
+    return true;
+}
+
+// ============================================================================
+// 조회
+// ============================================================================
+void RetainedCache::for_each(
+        const std::function<void(const std::string& topic, const std::string& payload)>& fn) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& [topic, payload] : values_) {
+        fn(topic, payload);
+    }
+}
+
+size_t RetainedCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return values_.size();
+}
+
+} // namespace mqtt_client
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "client_export.h"
+#include "mapped_file.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <mutex>
+#include <functional>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// retained 메시지 스냅샷 캐시 (토픽별 마지막 값, 메모리 매핑 파일에 영속화)
+//
+// 재시작 시 브로커의 retained 재전송을 기다리지 않고 바로 마지막 값을 사용할 수 있도록
+// 수신한 retained 메시지를 추가 전용 로그로 기록한다. 로그가 가득 차면 살아있는 값만
+// 남기도록 압축(필요하면 파일 확장)한다. 빈 payload 는 retained 삭제로 처리된다.
+//
+// 파일 형식: [헤더 magic/version/active/구간 2개(start, used)] [레코드: topic_len(u32) payload_len(u32) topic payload]...
+// 데이터 영역을 반으로 나눠 한쪽 구간에만 기록한다. 구간의 used 는 레코드를 다 쓴 뒤 갱신하고,
+// 압축은 반대쪽 반에 살아있는 값을 쓴 뒤 active 만 바꿔 커밋하므로
+// 어느 시점에 종료되어도 마지막으로 커밋된 구간이 유효하다 (그 대신 파일은 살아있는 값의 4배 이상으로 유지)
+class MQTT_CLIENT_API RetainedCache {
+public:
+    explicit RetainedCache(std::string path, size_t initial_capacity = 16 * 1024 * 1024);
+    ~RetainedCache();
+
+    RetainedCache(const RetainedCache&) = delete;
+    RetainedCache& operator=(const RetainedCache&) = delete;
+
+    // 파일을 열고 기존 내용을 읽어들임 (실패 시 false - 캐시 없이 동작)
+    bool open();
+    void close();
+    bool is_open() const { return file_.is_open(); }
+
+    // retained 메시지 반영 (빈 payload = 삭제) - 캐시 값과 같으면 false
+    bool update(std::string_view topic, std::string_view payload);
+
+    // 현재 스냅샷 순회
+    void for_each(const std::function<void(const std::string& topic, const std::string& payload)>& fn) const;
+    size_t size() const;
+
+private:
+    struct Region {
+        uint64_t start;     // 데이터 영역 기준 오프셋
+        uint64_t used;      // 유효 레코드 바이트 수
+    };
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        uint32_t active;    // 유효 구간 (0/1)
+        uint32_t reserved;
+        Region regions[2];
+    };
+    static constexpr uint32_t kVersion = 2;
+    static constexpr uint32_t kTombstone = 0xffffffffu;
+
+    bool append(std::string_view topic, std::string_view payload, bool tombstone);
+    bool compact();
+    void load();
+
+    Header* header() const { return reinterpret_cast<Header*>(file_.data()); }
+    char* records() const { return file_.data() + sizeof(Header); }
+    size_t records_size() const { return file_.size() - sizeof(Header); }
+    // 구간이 속한 반쪽의 끝 (구간은 반쪽 경계를 넘지 않음)
+    size_t region_limit(const Region& region) const {
+        return region.start < records_size() / 2 ? records_size() / 2 : records_size();
+    }
+
+    std::string path_;
+    size_t capacity_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::string> values_;
+    MappedFile file_;
+};
+
+} // namespace mqtt_client
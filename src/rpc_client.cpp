@@ -0,0 +1,262 @@
+#include "rpc_client.h"
+#include "log.h"
+#include <random>
+#include <sstream>
+#include <iomanip>
+
+namespace mqtt_client {
+
+namespace {
+
+constexpr std::string_view kRpcMagic = "RPC1\n";
+
+// "<field>\n" 하나를 잘라냄
+std::optional<std::string_view> take_line(std::string_view& data) {
+    size_t pos = data.find('\n');
+    if (pos == std::string_view::npos) {
+        return std::nullopt;
+    }
+    std::string_view line = data.substr(0, pos);
+    data.remove_prefix(pos + 1);
+    return line;
+}
+
+std::string to_hex(uint64_t value) {
+    std::ostringstream oss;
+    oss << std::hex << value;
+    return oss.str();
+}
+
+std::optional<uint64_t> parse_hex(std::string_view text) {
+    if (text.empty() || text.size() > 16) {
+        return std::nullopt;
+    }
+    uint64_t value = 0;
+    for (char c : text) {
+        value <<= 4;
+        if (c >= '0' && c <= '9') value |= static_cast<uint64_t>(c - '0');
+        else if (c >= 'a' && c <= 'f') value |= static_cast<uint64_t>(c - 'a' + 10);
+        else return std::nullopt;
+    }
+    return value;
+}
+
+} // namespace
+
+// ============================================================================
+// 생성 / 종료
+// ============================================================================
+RpcClient::RpcClient(MQTTClient& client, std::string reply_topic, int reply_qos)
+    : client_(client), reply_topic_(std::move(reply_topic)), reply_qos_(reply_qos) {
+    if (reply_topic_.empty()) {
+        std::random_device rd;
+        uint64_t random_id = (static_cast<uint64_t>(rd()) << 32) | rd();
+        reply_topic_ = "rpc/reply/" + to_hex(random_id);
+    }
+
+    interceptor_id_ = client_.add_message_interceptor([this](std::string_view topic, std::string_view payload, int) {
+        return on_message(topic, payload);
+    });
+    // cleansession 재연결로 세션을 잃을 때마다 응답 토픽 재구독 (연결 전환은 클라이언트가 구독 복원)
+    connect_listener_id_ = client_.add_connect_listener([this] {
+        client_.request_subscribe(reply_topic_, reply_qos_);
+    });
+    client_.request_subscribe(reply_topic_, reply_qos_);  // 이미 연결된 클라이언트
+
+    timeout_thread_ = std::thread([this] { timeout_loop(); });
+    MQTT_LOG("[RPC] Reply topic: " << reply_topic_);
+}
+
+RpcClient::~RpcClient() {
+    // 해제 후에는 훅이 this 로 호출되지 않음
+    client_.remove_message_interceptor(interceptor_id_);
+    client_.remove_connect_listener(connect_listener_id_);
+    client_.request_unsubscribe(reply_topic_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (timeout_thread_.joinable()) {
+        timeout_thread_.join();
+    }
+}
+
+// ============================================================================
+// 호출
+// ============================================================================
+std::future<std::string> RpcClient::call(const std::string& topic, const std::string& body,
+                                         std::chrono::milliseconds timeout, int qos) {
+    uint64_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
+    auto now = std::chrono::steady_clock::now();
+
+    std::future<std::string> future;
+    bool earliest = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Pending& pending = in_flight_[id];
+        pending.started = now;
+        pending.deadline = now + timeout;
+        future = pending.promise.get_future();
+        auto it = deadlines_.emplace(pending.deadline, id);
+        earliest = it == deadlines_.begin();
+    }
+    if (earliest) {
+        cv_.notify_all();  // 타임아웃 스레드가 더 이른 마감 시각으로 다시 대기
+    }
+    calls_.fetch_add(1, std::memory_order_relaxed);
+
+    std::string payload;
+    payload.reserve(kRpcMagic.size() + 17 + reply_topic_.size() + 1 + body.size());
+    payload.append(kRpcMagic);
+    payload.append(to_hex(id)).append(1, '\n');
+    payload.append(reply_topic_).append(1, '\n');
+    payload.append(body);
+    client_.request_publish(topic, payload, qos, false);
+    return future;
+}
+
+// Paho 수신 콜백 스레드에서 호출 - 응답 토픽이 아니면 통과시킴
+bool RpcClient::on_message(std::string_view topic, std::string_view payload) {
+    if (topic != reply_topic_) {
+        return false;
+    }
+
+    std::optional<uint64_t> id;
+    if (payload.substr(0, kRpcMagic.size()) == kRpcMagic) {
+        payload.remove_prefix(kRpcMagic.size());
+        if (auto line = take_line(payload)) {
+            id = parse_hex(line.value());
+        }
+    }
+
+    std::optional<Pending> pending;
+    if (id.has_value()) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = in_flight_.find(id.value());
+        if (it != in_flight_.end()) {
+            pending = std::move(it->second);
+            in_flight_.erase(it);
+            // deadlines_ 항목은 타임아웃 스레드가 in_flight_ 에 없는 것을 보고 정리
+        }
+    }
+
+    if (!pending.has_value()) {
+        late_replies_.fetch_add(1, std::memory_order_relaxed);
+        return true;  // 응답 토픽 메시지는 항상 소비
+    }
+
+    record_latency(std::chrono::steady_clock::now() - pending->started);
+    completed_.fetch_add(1, std::memory_order_relaxed);
+    pending->promise.set_value(std::string(payload));
+    return true;
+}
+
+void RpcClient::timeout_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        if (deadlines_.empty()) {
+            cv_.wait(lock);
+            continue;
+        }
+
+        auto next = deadlines_.begin()->first;
+        if (std::chrono::steady_clock::now() < next) {
+            cv_.wait_until(lock, next);
+            continue;
+        }
+
+        uint64_t id = deadlines_.begin()->second;
+        deadlines_.erase(deadlines_.begin());
+        auto it = in_flight_.find(id);
+        if (it == in_flight_.end()) {
+            continue;  // 이미 응답 수신
+        }
+        Pending pending = std::move(it->second);
+        in_flight_.erase(it);
+        timeouts_.fetch_add(1, std::memory_order_relaxed);
+
+        lock.unlock();
+        pending.promise.set_exception(std::make_exception_ptr(RpcTimeout("RPC call timed out")));
+        lock.lock();
+    }
+}
+
+void RpcClient::record_latency(std::chrono::steady_clock::duration elapsed) {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+    size_t bucket = 0;
+    while (us > 1 && bucket + 1 < kLatencyBuckets) {
+        us >>= 1;
+        ++bucket;
+    }
+    latency_histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+// ============================================================================
+// 통계
+// ============================================================================
+RpcClient::Stats RpcClient::get_stats() const {
+    Stats stats;
+    stats.calls = calls_.load(std::memory_order_relaxed);
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.timeouts = timeouts_.load(std::memory_order_relaxed);
+    stats.late_replies = late_replies_.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.in_flight = in_flight_.size();
+    }
+    for (size_t i = 0; i < kLatencyBuckets; ++i) {
+        stats.latency_us_histogram[i] = latency_histogram_[i].load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+uint64_t RpcClient::Stats::latency_percentile_us(double percentile) const {
+    uint64_t total = 0;
+    for (uint64_t count : latency_us_histogram) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    uint64_t target = static_cast<uint64_t>(static_cast<double>(total) * percentile / 100.0);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kLatencyBuckets; ++i) {
+        seen += latency_us_histogram[i];
+        if (seen > target || seen == total) {
+            return uint64_t{1} << (i + 1);
+        }
+    }
+    return uint64_t{1} << kLatencyBuckets;
+}
+
+// ============================================================================
+// 응답 측 헬퍼
+// ============================================================================
+std::optional<RpcRequest> RpcClient::parse_request(std::string_view payload) {
+    if (payload.substr(0, kRpcMagic.size()) != kRpcMagic) {
+        return std::nullopt;
+    }
+    payload.remove_prefix(kRpcMagic.size());
+    auto correlation_id = take_line(payload);
+    auto reply_topic = correlation_id ? take_line(payload) : std::nullopt;
+    if (!reply_topic.has_value() || reply_topic->empty()) {
+        return std::nullopt;
+    }
+    RpcRequest request;
+    request.correlation_id = std::string(correlation_id.value());
+    request.reply_topic = std::string(reply_topic.value());
+    request.body = std::string(payload);
+    return request;
+}
+
+std::string RpcClient::make_reply(const RpcRequest& request, std::string_view body) {
+    std::string payload;
+    payload.reserve(kRpcMagic.size() + request.correlation_id.size() + 1 + body.size());
+    payload.append(kRpcMagic);
+    payload.append(request.correlation_id).append(1, '\n');
+    payload.append(body);
+    return payload;
+}
+
+} // namespace mqtt_client
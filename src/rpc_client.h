@@ -0,0 +1,110 @@
+#pragma once
+
+#include "mqtt_client.h"
+#include <string>
+#include <string_view>
+#include <future>
+#include <unordered_map>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <array>
+#include <chrono>
+#include <optional>
+#include <stdexcept>
+
+namespace mqtt_client {
+
+// RPC 호출 제한 시간 초과
+class MQTT_CLIENT_API RpcTimeout : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// 수신 측에서 파싱한 RPC 요청
+struct RpcRequest {
+    std::string correlation_id;
+    std::string reply_topic;
+    std::string body;
+};
+
+// MQTT 요청/응답 RPC
+//
+// MQTT 3.1.1 에는 Response Topic / Correlation Data 속성이 없으므로 페이로드 앞에 헤더를 붙인다
+//   요청: "RPC1\n<correlation_id>\n<reply_topic>\n<body>"
+//   응답: "RPC1\n<correlation_id>\n<body>"
+// 응답 토픽은 클라이언트당 하나이며 한 번만 구독하고 (재연결 시 자동 재구독),
+// 응답은 수신 콜백에서 가로채 해시 인덱스 in-flight 테이블로 future 를 완료한다
+//
+// 소멸 시 수신 훅을 해제하고 응답 토픽 구독을 취소한다
+class MQTT_CLIENT_API RpcClient {
+public:
+    // 응답 지연 히스토그램: 버킷 i = [2^i, 2^(i+1)) 마이크로초
+    static constexpr size_t kLatencyBuckets = 32;
+
+    struct Stats {
+        uint64_t calls = 0;
+        uint64_t completed = 0;
+        uint64_t timeouts = 0;
+        uint64_t late_replies = 0;   // 제한 시간 이후 또는 알 수 없는 correlation id
+        size_t in_flight = 0;
+        std::array<uint64_t, kLatencyBuckets> latency_us_histogram{};
+
+        // 히스토그램 기반 백분위 (버킷 상한, 마이크로초)
+        uint64_t latency_percentile_us(double percentile) const;
+    };
+
+    // reply_topic 을 비우면 "rpc/reply/<무작위 ID>" 사용
+    explicit RpcClient(MQTTClient& client, std::string reply_topic = "", int reply_qos = 1);
+    ~RpcClient();
+
+    RpcClient(const RpcClient&) = delete;
+    RpcClient& operator=(const RpcClient&) = delete;
+
+    // 요청 발행 - 응답 body 로 완료되거나 제한 시간 초과 시 RpcTimeout 예외
+    std::future<std::string> call(const std::string& topic, const std::string& body,
+                                  std::chrono::milliseconds timeout = std::chrono::seconds(5),
+                                  int qos = 1);
+
+    const std::string& reply_topic() const { return reply_topic_; }
+    Stats get_stats() const;
+
+    // 응답 측 헬퍼
+    static std::optional<RpcRequest> parse_request(std::string_view payload);
+    static std::string make_reply(const RpcRequest& request, std::string_view body);
+
+private:
+    struct Pending {
+        std::promise<std::string> promise;
+        std::chrono::steady_clock::time_point started;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    bool on_message(std::string_view topic, std::string_view payload);
+    void timeout_loop();
+    void record_latency(std::chrono::steady_clock::duration elapsed);
+
+    MQTTClient& client_;
+    std::string reply_topic_;
+    int reply_qos_;
+    HookId interceptor_id_ = 0;
+    HookId connect_listener_id_ = 0;
+    std::atomic<uint64_t> next_id_{1};
+
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::unordered_map<uint64_t, Pending> in_flight_;
+    std::multimap<std::chrono::steady_clock::time_point, uint64_t> deadlines_;
+    bool stop_ = false;
+    std::thread timeout_thread_;
+
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    std::atomic<uint64_t> late_replies_{0};
+    std::array<std::atomic<uint64_t>, kLatencyBuckets> latency_histogram_{};
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "event_queue.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <mutex>
+#include <chrono>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// 토픽별 순서 보장 / 누락 감지 단계 (수신 → 큐잉 사이)
+//
+// 발행자가 페이로드에 넣은 시퀀스 번호를 extractor 로 읽어, 순서가 어긋난 메시지는
+// 토픽별 링 버퍼(window 크기)에 보관했다가 순서대로 내보낸다.
+// 빠진 번호는 gap_timeout 이 지나거나 버퍼가 넘치면 건너뛰고 SEQUENCE_GAP 이벤트를 보낸다.
+// 이미 지나간 번호(중복/지연 도착)는 버린다. 단 window 이상 뒤로 돌아간 번호는 발행자 재시작으로 보고
+// 보관 중인 메시지를 배출한 뒤 그 번호부터 다시 시작한다 (SEQUENCE_GAP 이벤트로 알림).
+// 메시지당 O(1) (연속 배출은 분할 상환), 큰 번호 도약도 O(window)
+class Sequencer {
+public:
+    // nullopt 이면 순서 처리 대상이 아님 (그대로 통과)
+    using SequenceExtractor = std::function<std::optional<uint64_t>(std::string_view topic,
+                                                                     std::string_view payload)>;
+
+    struct Stats {
+        uint64_t in_order = 0;
+        uint64_t reordered = 0;     // 버퍼에 보관되었다가 배출
+        uint64_t stale = 0;         // 이미 지나간 번호로 버려짐
+        uint64_t missing = 0;       // 건너뛴 번호 수
+        uint64_t restarts = 0;      // 큰 역방향 도약으로 스트림 재시작
+    };
+
+    explicit Sequencer(SequenceExtractor extractor, size_t window = 64,
+                       std::chrono::milliseconds gap_timeout = std::chrono::milliseconds(500))
+        : extractor_(std::move(extractor)),
+          window_(round_pow2(window)),
+          gap_timeout_(gap_timeout) {}
+
+    Sequencer(const Sequencer&) = delete;
+    Sequencer& operator=(const Sequencer&) = delete;
+
+    // 수신 메시지 처리 - 배출 가능한 이벤트를 순서대로 sink(MQTTEvent&&) 로 전달
+    template <typename Sink>
+    void process(MQTTEvent event, Sink&& sink) {
+        std::optional<uint64_t> seq = extractor_(event.topic, event.payload);
+        if (!seq.has_value()) {
+            sink(std::move(event));
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto [it, inserted] = streams_.try_emplace(event.topic);
+        Stream& stream = it->second;
+        if (inserted) {
+            stream.slots.resize(window_);
+            stream.next = seq.value();
+        }
+
+        if (seq.value() < stream.next) {
+            if (stream.next - seq.value() < window_) {
+                ++stats_.stale;
+                return;
+            }
+            // 발행자 재시작 - 이전 번호 체계의 보관 메시지를 배출하고 새 번호부터 다시 시작
+            flush(stream, sink);
+            ++stats_.restarts;
+            MQTTEvent restart(EventType::SEQUENCE_GAP,
+                              "Sequence restarted at " + std::to_string(seq.value()) +
+                              " (expected " + std::to_string(stream.next) + ")");
+            restart.topic = it->first;
+            sink(std::move(restart));
+            stream.next = seq.value();
+        }
+
+        if (seq.value() == stream.next) {
+            ++stats_.in_order;
+            ++stream.next;
+            sink(std::move(event));
+            drain(stream, sink);
+            return;
+        }
+
+        // 버퍼 범위를 넘으면 앞부분을 건너뛰어 자리 확보
+        if (seq.value() - stream.next >= window_) {
+            skip_to(it->first, stream, seq.value() - window_ + 1, sink);
+            drain(stream, sink);
+            if (seq.value() == stream.next) {
+                ++stats_.in_order;
+                ++stream.next;
+                sink(std::move(event));
+                drain(stream, sink);
+                return;
+            }
+        }
+
+        auto& slot = stream.slots[seq.value() & (window_ - 1)];
+        if (slot.has_value()) {
+            ++stats_.stale;  // 같은 번호 중복
+            return;
+        }
+        slot = std::move(event);
+        ++stream.held;
+        if (stream.held == 1) {
+            stream.gap_since = std::chrono::steady_clock::now();
+        }
+    }
+
+    // process() 가 지난 번호 / 중복으로 버릴 메시지인지 (상태를 바꾸지 않음)
+    bool is_stale(std::string_view topic, std::string_view payload) const {
+        std::optional<uint64_t> seq = extractor_(topic, payload);
+        if (!seq.has_value()) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = streams_.find(std::string(topic));
+        if (it == streams_.end()) {
+            return false;
+        }
+        const Stream& stream = it->second;
+        if (seq.value() < stream.next) {
+            return stream.next - seq.value() < window_;
+        }
+        return seq.value() - stream.next < window_ && stream.slots[seq.value() & (window_ - 1)].has_value();
+    }
+
+    // 주기적으로 호출 - gap_timeout 이 지난 누락 번호를 건너뛰고 보관 중인 메시지 배출
+    template <typename Sink>
+    void poll(Sink&& sink) {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& [topic, stream] : streams_) {
+            if (stream.held == 0 || now - stream.gap_since < gap_timeout_) {
+                continue;
+            }
+            // 다음 보관 메시지까지 건너뜀
+            uint64_t target = stream.next;
+            while (!stream.slots[target & (window_ - 1)].has_value()) {
+                ++target;
+            }
+            skip_to(topic, stream, target, sink);
+            drain(stream, sink);
+            if (stream.held > 0) {
+                stream.gap_since = now;
+            }
+        }
+    }
+
+    Stats get_stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    struct Stream {
+        uint64_t next = 0;                          // 다음으로 기대하는 번호
+        std::vector<std::optional<MQTTEvent>> slots; // 링 버퍼 (seq & (window-1))
+        size_t held = 0;
+        std::chrono::steady_clock::time_point gap_since;
+    };
+
+    static size_t round_pow2(size_t n) {
+        size_t p = 2;
+        while (p < n) p <<= 1;
+        return p;
+    }
+
+    // next 부터 연속으로 보관된 메시지 배출
+    template <typename Sink>
+    void drain(Stream& stream, Sink& sink) {
+        while (stream.held > 0) {
+            auto& slot = stream.slots[stream.next & (window_ - 1)];
+            if (!slot.has_value()) {
+                break;
+            }
+            ++stats_.reordered;
+            --stream.held;
+            ++stream.next;
+            MQTTEvent event = std::move(slot.value());
+            slot.reset();
+            sink(std::move(event));
+        }
+    }
+
+    // next 를 target 까지 전진 - 보관된 메시지는 배출, 빈 번호 구간은 SEQUENCE_GAP 으로 알림
+    // 보관 메시지는 모두 [next, next + window) 안에 있으므로, 다 배출한 뒤 남은 구간은 한 번에 건너뛴다 (O(window))
+    template <typename Sink>
+    void skip_to(const std::string& topic, Stream& stream, uint64_t target, Sink& sink) {
+        while (stream.next < target) {
+            auto& slot = stream.slots[stream.next & (window_ - 1)];
+            if (slot.has_value()) {
+                drain(stream, sink);
+                continue;
+            }
+            uint64_t first = stream.next;
+            if (stream.held == 0) {
+                stream.next = target;
+            }
+            while (stream.next < target && !stream.slots[stream.next & (window_ - 1)].has_value()) {
+                ++stream.next;
+            }
+            stats_.missing += stream.next - first;
+            MQTTEvent gap(EventType::SEQUENCE_GAP,
+                          "Missing sequence " + std::to_string(first) + "-" + std::to_string(stream.next - 1));
+            gap.topic = topic;
+            sink(std::move(gap));
+        }
+    }
+
+    // 보관된 메시지를 번호 순으로 모두 배출 (누락 알림 없음, next 는 호출자가 재설정)
+    template <typename Sink>
+    void flush(Stream& stream, Sink& sink) {
+        for (uint64_t seq = stream.next; stream.held > 0 && seq - stream.next < window_; ++seq) {
+            auto& slot = stream.slots[seq & (window_ - 1)];
+            if (!slot.has_value()) {
+                continue;
+            }
+            ++stats_.reordered;
+            --stream.held;
+            MQTTEvent event = std::move(slot.value());
+            slot.reset();
+            sink(std::move(event));
+        }
+    }
+
+    SequenceExtractor extractor_;
+    size_t window_;
+    std::chrono::milliseconds gap_timeout_;
+
+    mutable std::mutex mutex_;  // 수신 스레드와 MQTT 스레드(poll) 공유
+    std::unordered_map<std::string, Stream> streams_;
+    Stats stats_;
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string_view>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// 토픽 해시 (FNV-1a) - 수신 경로의 고정 크기 테이블(중복 제거, 최신 값 캐시, 전달 정책, 토픽 통계) 공용
+inline uint64_t topic_hash(std::string_view topic) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : topic) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// MQTT 토픽 필터 매칭 ('+' 단일 레벨, '#' 다중 레벨)
+// 할당 없이 동작하므로 수신 콜백 경로에서 사용할 수 있다
+inline bool topic_matches(std::string_view filter, std::string_view topic) {
+    // '$' 로 시작하는 시스템 토픽은 와일드카드로 시작하는 필터와 매칭되지 않음
+    if (!topic.empty() && topic[0] == '$' && !filter.empty() &&
+        (filter[0] == '+' || filter[0] == '#')) {
+        return false;
+    }
+
+    for (;;) {
+        size_t filter_sep = filter.find('/');
+        std::string_view filter_level = filter.substr(0, filter_sep);
+        if (filter_level == "#") {
+            return true;
+        }
+
+        size_t topic_sep = topic.find('/');
+        if (filter_level != "+" && filter_level != topic.substr(0, topic_sep)) {
+            return false;
+        }
+
+        bool filter_last = filter_sep == std::string_view::npos;
+        bool topic_last = topic_sep == std::string_view::npos;
+        if (filter_last || topic_last) {
+            if (filter_last && topic_last) {
+                return true;
+            }
+            // "a/#" 는 부모 레벨 "a" 와도 매칭된다
+            return topic_last && filter.substr(filter_sep + 1) == "#";
+        }
+        filter.remove_prefix(filter_sep + 1);
+        topic.remove_prefix(topic_sep + 1);
+    }
+}
+
+} // namespace mqtt_client
@@ -0,0 +1,174 @@
+#pragma once
+
+#include "topic_filter.h"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <algorithm>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// 토픽별 트래픽 상위 K (heavy hitters) - Space-Saving 스케치, 메모리 고정
+//
+// 방향(수신/송신)별로 메시지 수와 바이트 수를 각각 capacity 개의 카운터로 추적한다
+// 카운터가 가득 차면 가장 작은 카운터를 새 토픽에 넘겨주므로, 보고되는 값은 실제보다
+// 최대 error 만큼 클 수 있다 (실제 값 >= count - error). 빈도가 전체의 1/capacity 를 넘는 토픽은 반드시 포함된다
+class TopicStats {
+public:
+    enum class Direction { INBOUND, OUTBOUND };
+    enum class Metric { MESSAGES, BYTES };
+
+    struct Entry {
+        std::string topic;
+        uint64_t count = 0;
+        uint64_t error = 0;     // 과대 추정 상한
+    };
+
+    explicit TopicStats(size_t capacity = 1024)
+        : inbound_(capacity), outbound_(capacity) {}
+
+    TopicStats(const TopicStats&) = delete;
+    TopicStats& operator=(const TopicStats&) = delete;
+
+    void record(Direction direction, std::string_view topic, size_t bytes) {
+        uint64_t hash = topic_hash(topic);
+        Side& side = direction == Direction::INBOUND ? inbound_ : outbound_;
+        std::lock_guard<std::mutex> lock(side.mutex);
+        side.messages.add(hash, topic, 1);
+        side.bytes.add(hash, topic, bytes);
+    }
+
+    // 상위 k 개 (큰 순서)
+    std::vector<Entry> top(Direction direction, Metric metric, size_t k) const {
+        const Side& side = direction == Direction::INBOUND ? inbound_ : outbound_;
+        std::vector<Entry> entries;
+        {
+            std::lock_guard<std::mutex> lock(side.mutex);
+            entries = (metric == Metric::MESSAGES ? side.messages : side.bytes).entries();
+        }
+        k = std::min(k, entries.size());
+        std::partial_sort(entries.begin(), entries.begin() + static_cast<std::ptrdiff_t>(k), entries.end(),
+                          [](const Entry& a, const Entry& b) { return a.count > b.count; });
+        entries.resize(k);
+        return entries;
+    }
+
+    void clear() {
+        for (Side* side : {&inbound_, &outbound_}) {
+            std::lock_guard<std::mutex> lock(side->mutex);
+            side->messages.clear();
+            side->bytes.clear();
+        }
+    }
+
+private:
+    // 가중 Space-Saving - 카운터를 최소 힙으로 유지해 최솟값 교체를 O(log capacity) 로 처리
+    class SpaceSaving {
+    public:
+        explicit SpaceSaving(size_t capacity) : capacity_(std::max<size_t>(capacity, 1)) {
+            heap_.reserve(capacity_);
+            index_.reserve(capacity_ * 2);
+        }
+
+        void add(uint64_t hash, std::string_view topic, uint64_t weight) {
+            auto it = index_.find(hash);
+            if (it != index_.end()) {
+                heap_[it->second].count += weight;
+                sift_down(it->second);
+                return;
+            }
+            if (heap_.size() < capacity_) {
+                heap_.push_back(Counter{hash, std::string(topic), weight, 0});
+                index_[hash] = heap_.size() - 1;
+                sift_up(heap_.size() - 1);
+                return;
+            }
+            // 최솟값 카운터를 새 토픽에 넘김
+            Counter& min = heap_[0];
+            index_.erase(min.hash);
+            min.error = min.count;
+            min.count += weight;
+            min.hash = hash;
+            min.topic.assign(topic.data(), topic.size());
+            index_[hash] = 0;
+            sift_down(0);
+        }
+
+        std::vector<Entry> entries() const {
+            std::vector<Entry> out;
+            out.reserve(heap_.size());
+            for (const auto& counter : heap_) {
+                out.push_back(Entry{counter.topic, counter.count, counter.error});
+            }
+            return out;
+        }
+
+        void clear() {
+            heap_.clear();
+            index_.clear();
+        }
+
+    private:
+        struct Counter {
+            uint64_t hash;
+            std::string topic;
+            uint64_t count;
+            uint64_t error;
+        };
+
+        void swap_nodes(size_t a, size_t b) {
+            std::swap(heap_[a], heap_[b]);
+            index_[heap_[a].hash] = a;
+            index_[heap_[b].hash] = b;
+        }
+
+        void sift_up(size_t pos) {
+            while (pos > 0) {
+                size_t parent = (pos - 1) / 2;
+                if (heap_[parent].count <= heap_[pos].count) {
+                    break;
+                }
+                swap_nodes(pos, parent);
+                pos = parent;
+            }
+        }
+
+        void sift_down(size_t pos) {
+            for (;;) {
+                size_t smallest = pos;
+                size_t left = pos * 2 + 1;
+                size_t right = left + 1;
+                if (left < heap_.size() && heap_[left].count < heap_[smallest].count) {
+                    smallest = left;
+                }
+                if (right < heap_.size() && heap_[right].count < heap_[smallest].count) {
+                    smallest = right;
+                }
+                if (smallest == pos) {
+                    return;
+                }
+                swap_nodes(pos, smallest);
+                pos = smallest;
+            }
+        }
+
+        size_t capacity_;
+        std::vector<Counter> heap_;
+        std::unordered_map<uint64_t, size_t> index_;  // 토픽 해시 → 힙 위치 (문자열 키 할당 없음)
+    };
+
+    struct Side {
+        explicit Side(size_t capacity) : messages(capacity), bytes(capacity) {}
+        mutable std::mutex mutex;  // 수신은 Paho 콜백 스레드, 송신은 MQTT 스레드에서 갱신
+        SpaceSaving messages;
+        SpaceSaving bytes;
+    };
+
+    Side inbound_;
+    Side outbound_;
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <memory>
+#include <random>
+#include <chrono>
+#include <string_view>
+#include <cstdint>
+
+namespace mqtt_client {
+
+// 분산 추적 span (발행/수신 수명 주기) - OpenTelemetry 등 외부 추적 시스템 연동용
+//
+// MQTT_ENABLE_TRACING 으로 빌드했을 때만 span 을 만든다 (CMake 옵션)
+// 비활성 빌드에서는 추적 코드와 이벤트/작업의 추적 문맥 필드가 모두 컴파일에서 빠진다
+// 활성 빌드에서도 Tracer 가 없거나 샘플링되지 않은 메시지는 포인터/정수 비교 한 번만 수행한다
+//
+// 발행: mqtt.publish (request_publish ~ 브로커 응답)
+//   └ mqtt.publish.queue (대기열) / mqtt.publish.send (MQTTAsync_sendMessage) / mqtt.publish.ack (응답 대기)
+// 수신: mqtt.receive (on_message_arrived ~ 핸들러 완료, MQTTClient::trace_handled 호출 시점)
+//   └ mqtt.receive.callback (수신 콜백) / mqtt.receive.queue (이벤트 큐) / mqtt.receive.handler
+
+// 추적 문맥 - trace_id 가 0 이면 샘플링되지 않음 (시각은 system_clock 기준 ns)
+struct TraceContext {
+    uint64_t trace_id = 0;
+    uint64_t span_id = 0;       // 루트(수명 주기) span
+    int64_t start_ns = 0;       // 루트 span 시작
+    int64_t mark_ns = 0;        // 직전 단계가 끝난 시각
+    int64_t dequeued_ns = 0;    // 이벤트 큐에서 꺼낸 시각 (수신)
+
+    bool sampled() const { return trace_id != 0; }
+};
+
+struct Span {
+    std::string_view name;
+    uint64_t trace_id;
+    uint64_t span_id;
+    uint64_t parent_span_id;    // 0 이면 루트 span
+    int64_t start_ns;
+    int64_t end_ns;
+    std::string_view topic;
+    bool ok;
+};
+
+// span 수신자 - MQTT 스레드, Paho 콜백 스레드, 애플리케이션 스레드에서 호출되므로 thread-safe 해야 한다
+class TraceSink {
+public:
+    virtual ~TraceSink() = default;
+    virtual void on_span(const Span& span) = 0;
+};
+
+// 샘플링 및 span 생성 - 스레드별 난수 생성기를 사용하므로 공유 잠금/원자 연산 없음
+class Tracer {
+public:
+    // sample_ratio: 추적할 수명 주기 비율 (0.0 ~ 1.0)
+    explicit Tracer(std::shared_ptr<TraceSink> sink, double sample_ratio = 1.0)
+        : sink_(std::move(sink)) {
+        if (sample_ratio >= 1.0) {
+            threshold_ = UINT64_MAX;
+        } else if (sample_ratio > 0.0) {
+            threshold_ = static_cast<uint64_t>(sample_ratio * 9007199254740992.0) << 11;  // 2^53 단위
+        }
+    }
+
+    static int64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // 새 수명 주기 시작 (샘플링되지 않으면 빈 문맥)
+    TraceContext start() {
+        TraceContext context;
+        if (!sink_ || threshold_ == 0 || random_id() > threshold_) {
+            return context;
+        }
+        context.trace_id = random_id();
+        context.span_id = random_id();
+        context.start_ns = now_ns();
+        context.mark_ns = context.start_ns;
+        return context;
+    }
+
+    // 하위 단계 span
+    void span(const TraceContext& context, std::string_view name, int64_t start_ns, int64_t end_ns,
+              std::string_view topic, bool ok = true) {
+        if (!context.sampled()) {
+            return;
+        }
+        sink_->on_span(Span{name, context.trace_id, random_id(), context.span_id,
+                            start_ns, end_ns, topic, ok});
+    }
+
+    // 루트 span 종료
+    void finish(const TraceContext& context, std::string_view name, std::string_view topic, bool ok = true) {
+        if (!context.sampled()) {
+            return;
+        }
+        sink_->on_span(Span{name, context.trace_id, context.span_id, 0,
+                            context.start_ns, now_ns(), topic, ok});
+    }
+
+private:
+    static uint64_t random_id() {
+        thread_local std::mt19937_64 generator{std::random_device{}()};
+        uint64_t id;
+        do {
+            id = generator();
+        } while (id == 0);
+        return id;
+    }
+
+    std::shared_ptr<TraceSink> sink_;
+    uint64_t threshold_ = 0;
+};
+
+} // namespace mqtt_client
@@ -0,0 +1,72 @@
+// DedupFilter 단위 테스트 - 창 안의 중복 판정, 용량보다 많은 키 순환 시 해시 테이블 점유
+#include "src/dedup_filter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using namespace mqtt_client;
+
+namespace {
+
+int g_failures = 0;
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++g_failures;                                                        \
+        }                                                                        \
+    } while (0)
+
+// 페이로드 = 메시지 ID (10진수)
+DedupFilter::KeyExtractor payload_key() {
+    return [](std::string_view, std::string_view payload) -> std::optional<uint64_t> {
+        return std::stoull(std::string(payload));
+    };
+}
+
+void test_duplicate_in_window() {
+    DedupFilter filter(16, std::chrono::seconds(30), payload_key());
+    CHECK(!filter.is_duplicate("t", "1", 0, false));
+    CHECK(!filter.is_duplicate("t", "2", 0, false));
+    CHECK(filter.is_duplicate("t", "1", 0, false));
+    CHECK(filter.duplicates() == 1);
+}
+
+void test_packet_id_requires_dup_flag() {
+    DedupFilter filter(16, std::chrono::seconds(30));
+    CHECK(!filter.is_duplicate("t", "a", 7, false));
+    CHECK(!filter.is_duplicate("t", "b", 7, false));  // 재사용된 패킷 ID
+    CHECK(filter.is_duplicate("t", "b", 7, true));    // 브로커 재전송
+}
+
+// Bloom 두 세대에서 모두 빠졌지만 LRU 에 남은 키가 다시 와도 노드가 늘지 않아야 한다
+// (패킷 ID 재사용과 같은 상황 - 창보다 긴 간격으로 같은 키가 섞여 들어옴)
+void test_rotating_keys_across_windows() {
+    const size_t capacity = 4;
+    DedupFilter filter(capacity, std::chrono::milliseconds(4), payload_key());
+    uint32_t state = 1;
+    for (int i = 0; i < 300; ++i) {
+        state = state * 1103515245u + 12345u;
+        filter.is_duplicate("t", std::to_string((state >> 16) % 5), 0, false);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        CHECK(filter.occupied_slots() <= capacity);
+    }
+    CHECK(filter.occupied_slots() == capacity);
+}
+
+} // namespace
+
+int main() {
+    test_duplicate_in_window();
+    test_packet_id_requires_dup_flag();
+    test_rotating_keys_across_windows();
+    if (g_failures > 0) {
+        std::fprintf(stderr, "%d check(s) failed\n", g_failures);
+        return EXIT_FAILURE;
+    }
+    std::puts("dedup_filter_test: OK");
+    return EXIT_SUCCESS;
+}